@@ -41,4 +41,21 @@ private:
     ConditionVec &conditions_;
 };
 
+// Writes aspif like Potassco::AspifOutput but also the conditions of theory
+// elements, which are looked up in the vector filled by AspifCInput.
+class AspifCOutput : public Potassco::AspifOutput {
+public:
+    AspifCOutput(std::ostream &os, ConditionVec const &conditions)
+    : Potassco::AspifOutput(os)
+    , conditions_(conditions) { }
+    virtual ~AspifCOutput() noexcept = default;
+protected:
+    virtual void theoryCondition(unsigned cId) {
+        if (cId == 0) { add(Potassco::toSpan<Potassco::Lit_t>()); }
+        else          { add(Potassco::toSpan(conditions_[cId - 1])); }
+    }
+private:
+    ConditionVec const &conditions_;
+};
+
 #endif
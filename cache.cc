@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2015, Anonymous Author (temporary)
+//
+// This file is part of lc2casp. See https://github.com/lc2casp/lc2casp
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "cache.hh"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+TranslationCache::TranslationCache(std::string dir, uint64_t limit)
+: dir_(std::move(dir))
+, limit_(limit) {
+    if (mkdir(dir_.c_str(), 0777) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Could not create cache directory!");
+    }
+}
+
+TranslationCache::Key TranslationCache::hash(std::string const &data, Key seed) {
+    // FNV-1a
+    for (unsigned char c : data) {
+        seed ^= c;
+        seed *= 1099511628211ull;
+    }
+    return seed;
+}
+
+std::string TranslationCache::path(Key key) const {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(key));
+    return dir_ + "/" + buf + ".aspif";
+}
+
+bool TranslationCache::load(Key key, std::ostream &out) const {
+    std::string name = path(key);
+    std::ifstream in(name.c_str(), std::ios::binary);
+    if (!in.is_open()) { return false; }
+    utime(name.c_str(), nullptr);
+    out << in.rdbuf();
+    return true;
+}
+
+bool TranslationCache::store(Key key, std::string const &data) {
+    std::string name = path(key);
+    static std::atomic<unsigned> counter(0);
+    std::string temp = name + "." + std::to_string(getpid()) + "." + std::to_string(counter++) + ".tmp";
+    std::ofstream out(temp.c_str(), std::ios::binary);
+    if (!out.is_open()) { return false; }
+    out.write(data.data(), data.size());
+    out.close();
+    if (!out || std::rename(temp.c_str(), name.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    evict(name);
+    return true;
+}
+
+TranslationCache::File TranslationCache::classify(std::string const &name) {
+    // entries are named <16 hex digits>.aspif
+    // and temporary files <entry>.<pid>.<counter>.tmp
+    static char const suffix[] = ".aspif";
+    size_t n = 16 + sizeof(suffix) - 1;
+    if (name.size() < n || name.compare(16, sizeof(suffix) - 1, suffix) != 0) { return File::Other; }
+    for (size_t i = 0; i < 16; ++i) {
+        if (!std::isxdigit(static_cast<unsigned char>(name[i])) || std::isupper(static_cast<unsigned char>(name[i]))) { return File::Other; }
+    }
+    if (name.size() == n) { return File::Entry; }
+    size_t pos = n;
+    for (int part = 0; part < 2; ++part) {
+        if (pos >= name.size() || name[pos] != '.') { return File::Other; }
+        size_t begin = ++pos;
+        while (pos < name.size() && std::isdigit(static_cast<unsigned char>(name[pos]))) { ++pos; }
+        if (pos == begin) { return File::Other; }
+    }
+    return name.compare(pos, std::string::npos, ".tmp") == 0 ? File::Temporary : File::Other;
+}
+
+void TranslationCache::evict(std::string const &keep) const {
+    // Note: temporary files might still be written by other threads or processes,
+    //       so only those older than a day are considered leftovers of aborted writers
+    constexpr time_t tempTimeout = 24 * 60 * 60;
+    struct Entry {
+        time_t time;
+        off_t size;
+        std::string name;
+    };
+    std::vector<Entry> entries;
+    uint64_t size = 0;
+    struct stat st;
+    if (stat(keep.c_str(), &st) == 0) { size += st.st_size; }
+    if (DIR *dir = opendir(dir_.c_str())) {
+        time_t now = std::time(nullptr);
+        while (dirent *ent = readdir(dir)) {
+            File type = classify(ent->d_name);
+            if (type == File::Other) { continue; }
+            std::string name = dir_ + "/" + ent->d_name;
+            if (name != keep && stat(name.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                if (type == File::Temporary && now - st.st_mtime < tempTimeout) { continue; }
+                size += st.st_size;
+                entries.push_back({st.st_mtime, st.st_size, std::move(name)});
+            }
+        }
+        closedir(dir);
+    }
+    if (size <= limit_) { return; }
+    std::sort(entries.begin(), entries.end(), [](Entry const &a, Entry const &b) { return a.time < b.time; });
+    for (auto &&ent : entries) {
+        if (size <= limit_) { break; }
+        if (std::remove(ent.name.c_str()) == 0) { size -= ent.size; }
+    }
+}
@@ -0,0 +1,50 @@
+//
+// Copyright (c) 2015, Anonymous Author (temporary)
+//
+// This file is part of lc2casp. See https://github.com/lc2casp/lc2casp
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef LIBFOUNDED_CACHE_H_INCLUDED
+#define LIBFOUNDED_CACHE_H_INCLUDED
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// On-disk cache of translated programs.
+// Entries are keyed by a hash of the input program and the translation options.
+// They are written atomically and evicted least recently used first once the
+// cache grows beyond its size limit. Only files named like entries are
+// evicted, so other files in the cache directory are left alone.
+class TranslationCache {
+public:
+    using Key = uint64_t;
+    TranslationCache(std::string dir, uint64_t limit);
+    static Key hash(std::string const &data, Key seed = 14695981039346656037ull);
+    // Streams the entry for the given key to out and marks it as recently used.
+    bool load(Key key, std::ostream &out) const;
+    // Stores data as the entry for the given key; returns false if the entry
+    // could not be written, e.g., because another writer interfered.
+    bool store(Key key, std::string const &data);
+private:
+    enum class File { Entry, Temporary, Other };
+    std::string path(Key key) const;
+    static File classify(std::string const &name);
+    void evict(std::string const &keep) const;
+
+    std::string dir_;
+    uint64_t limit_;
+};
+
+#endif
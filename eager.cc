@@ -0,0 +1,632 @@
+//
+// Copyright (c) 2015, Anonymous Author (temporary)
+//
+// This file is part of lc2casp. See https://github.com/lc2casp/lc2casp
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "eager.hh"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <sstream>
+
+using namespace Potassco;
+
+// {{{1 EagerEncoder::Linear
+
+struct EagerEncoder::Linear {
+    void simplify() {
+        std::sort(terms.begin(), terms.end());
+        auto it = terms.begin();
+        for (auto jt = terms.begin(), je = terms.end(); jt != je; ) {
+            auto t = *jt;
+            for (++jt; jt != je && jt->first == t.first; ++jt) { t.second+= jt->second; }
+            if (t.second != 0) { *it++ = t; }
+        }
+        terms.erase(it, terms.end());
+    }
+    Linear negated() const {
+        Linear ret = *this;
+        for (auto &t : ret.terms) { t.second = -t.second; }
+        ret.fixed = -ret.fixed;
+        return ret;
+    }
+    std::vector<std::pair<Id_t, int64_t>> terms;
+    int64_t fixed = 0;
+};
+
+// {{{1 EagerEncoder::Variable
+
+struct EagerEncoder::Variable {
+    // the sorted domain of the variable
+    std::vector<int> values;
+    // order[i] holds iff the variable is at most values[i]; there is no literal for the last value
+    std::vector<Lit_t> order;
+    unsigned doms = 0;
+    bool eager = true;
+};
+
+// {{{1 EagerEncoder::View
+
+// A variable multiplied with a coefficient; its values are enumerated in ascending order.
+struct EagerEncoder::View {
+    size_t size() const { return var->values.size(); }
+    int64_t value(size_t i) const {
+        return coef > 0 ? coef * var->values[i] : coef * var->values[size() - 1 - i];
+    }
+    // the literal for view >= value(i) with i > 0
+    Lit_t ge(size_t i) const {
+        return coef > 0 ? -var->order[i - 1] : var->order[size() - 1 - i];
+    }
+    Variable const *var;
+    int64_t coef;
+    // the smallest and largest sum of the following views
+    int64_t minRest;
+    int64_t maxRest;
+};
+
+// {{{1 EagerEncoder
+
+EagerEncoder::EagerEncoder(Gringo::Output::Backend &out, Gringo::Output::TheoryData &data, unsigned limit)
+: out_(out)
+, data_(data)
+, theory_(data.data())
+, limit_(limit) { }
+
+EagerEncoder::~EagerEncoder() noexcept = default;
+
+bool EagerEncoder::isSymbol(Id_t termId, char const *name) const {
+    auto &&term = theory_.getTerm(termId);
+    return term.type() == Theory_t::Symbol && std::strcmp(term.symbol(), name) == 0;
+}
+
+EagerEncoder::Kind EagerEncoder::kind(TheoryAtom const &atom) const {
+    if (isSymbol(atom.term(), "dom"))      { return Kind::Dom; }
+    if (isSymbol(atom.term(), "show"))     { return Kind::Show; }
+    if (isSymbol(atom.term(), "sum"))      { return Kind::Sum; }
+    if (isSymbol(atom.term(), "distinct")) { return Kind::Distinct; }
+    if (isSymbol(atom.term(), "minimize")) { return Kind::Minimize; }
+    return Kind::Other;
+}
+
+namespace {
+
+bool isOperator(char const *name) {
+    char buf[2] = { *name, 0 };
+    return std::strpbrk(buf, "/!<=>+-*\\?&@|:;~^.") != nullptr;
+}
+
+} // namespace
+
+bool EagerEncoder::parse(Id_t termId, int64_t factor, Linear &lin) const {
+    auto &&term = theory_.getTerm(termId);
+    switch (term.type()) {
+        case Theory_t::Number: {
+            lin.fixed+= factor * term.number();
+            return true;
+        }
+        case Theory_t::Symbol: {
+            lin.terms.emplace_back(termId, factor);
+            return true;
+        }
+        case Theory_t::Compound: {
+            if (!term.isFunction()) { return false; }
+            bool add = isSymbol(term.function(), "+"), sub = isSymbol(term.function(), "-");
+            if ((add || sub) && term.size() == 2) {
+                return parse(*term.begin(), factor, lin) && parse(*(term.begin() + 1), sub ? -factor : factor, lin);
+            }
+            if ((add || sub) && term.size() == 1) {
+                return parse(*term.begin(), sub ? -factor : factor, lin);
+            }
+            if (isSymbol(term.function(), "*") && term.size() == 2) {
+                Linear a, b;
+                if (!parse(*term.begin(), 1, a) || !parse(*(term.begin() + 1), 1, b)) { return false; }
+                if (!a.terms.empty() && !b.terms.empty()) { return false; }
+                Linear &c = a.terms.empty() ? a : b, &v = a.terms.empty() ? b : a;
+                for (auto &t : v.terms) { lin.terms.emplace_back(t.first, factor * c.fixed * t.second); }
+                lin.fixed+= factor * c.fixed * v.fixed;
+                return true;
+            }
+            if (isOperator(theory_.getTerm(term.function()).symbol())) { return false; }
+            lin.terms.emplace_back(termId, factor);
+            return true;
+        }
+    }
+    return false;
+}
+
+void EagerEncoder::collect(Id_t termId, std::vector<Id_t> &vars) const {
+    auto &&term = theory_.getTerm(termId);
+    switch (term.type()) {
+        case Theory_t::Number: { break; }
+        case Theory_t::Symbol: {
+            vars.emplace_back(termId);
+            break;
+        }
+        case Theory_t::Compound: {
+            if (term.isFunction() && !isOperator(theory_.getTerm(term.function()).symbol())) {
+                vars.emplace_back(termId);
+                break;
+            }
+            for (auto &&t : term) { collect(t, vars); }
+            break;
+        }
+    }
+}
+
+bool EagerEncoder::parseDom(TheoryAtom const &atom, std::vector<int> &values) const {
+    if (atom.atom() != 0 || !atom.guard() || !isSymbol(*atom.guard(), "=")) { return false; }
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+    for (auto &&elemId : atom) {
+        auto &&elem = theory_.getElement(elemId);
+        if (elem.size() != 1 || !data_.getCondition(elemId).empty()) { return false; }
+        auto &&term = theory_.getTerm(*elem.begin());
+        if (term.type() == Theory_t::Number) {
+            ranges.emplace_back(term.number(), term.number());
+            continue;
+        }
+        if (term.type() != Theory_t::Compound || !term.isFunction() || term.size() != 2 || !isSymbol(term.function(), "..")) { return false; }
+        auto &&l = theory_.getTerm(*term.begin());
+        auto &&r = theory_.getTerm(*(term.begin() + 1));
+        if (l.type() != Theory_t::Number || r.type() != Theory_t::Number) { return false; }
+        if (l.number() <= r.number()) { ranges.emplace_back(l.number(), r.number()); }
+    }
+    std::sort(ranges.begin(), ranges.end());
+    uint64_t size = 0;
+    int64_t last = std::numeric_limits<int64_t>::min();
+    for (auto &rng : ranges) {
+        int64_t l = std::max(rng.first, last);
+        if (l <= rng.second) {
+            size+= rng.second - l + 1;
+            if (size > limit_) { return false; }
+            for (int64_t x = l; x <= rng.second; ++x) { values.emplace_back(static_cast<int>(x)); }
+            last = rng.second + 1;
+        }
+    }
+    return true;
+}
+
+uint64_t EagerEncoder::estimate(Linear const &lin) const {
+    // the clauses of a constraint are enumerated over all but the largest domain
+    std::vector<uint64_t> sizes;
+    for (auto &t : lin.terms) {
+        auto it = vars_.find(t.first);
+        sizes.emplace_back(it != vars_.end() ? it->second.values.size() : 0);
+    }
+    std::sort(sizes.begin(), sizes.end());
+    uint64_t ret = 1;
+    for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+        ret = std::min<uint64_t>(ret * std::max<uint64_t>(sizes[i], 1), uint64_t(limit_) + 1);
+    }
+    return ret;
+}
+
+bool EagerEncoder::analyze(Constraint &c) const {
+    auto &&atom = *c.atom;
+    auto collectAll = [&]() {
+        for (auto &&elemId : atom) {
+            for (auto &&t : theory_.getElement(elemId)) { collect(t, c.vars); }
+        }
+        if (atom.rhs()) { collect(*atom.rhs(), c.vars); }
+    };
+    auto unconditional = [&]() {
+        for (auto &&elemId : atom) {
+            if (theory_.getElement(elemId).size() == 0 || !data_.getCondition(elemId).empty()) { return false; }
+        }
+        return true;
+    };
+    auto addVars = [&](Linear const &lin) {
+        for (auto &t : lin.terms) { c.vars.emplace_back(t.first); }
+    };
+    uint64_t clauses = 0;
+    switch (c.kind) {
+        case Kind::Sum: {
+            char const *rels[] = { "<=", ">=", "<", ">", "=", "==", "!=" };
+            if (atom.atom() == 0 || !atom.guard() || !unconditional() || std::none_of(std::begin(rels), std::end(rels), [&](char const *rel) { return isSymbol(*atom.guard(), rel); })) { break; }
+            Linear lin;
+            bool ok = parse(*atom.rhs(), -1, lin);
+            for (auto &&elemId : atom) { ok = ok && parse(*theory_.getElement(elemId).begin(), 1, lin); }
+            if (!ok) { break; }
+            lin.simplify();
+            addVars(lin);
+            clauses = 4 * estimate(lin);
+            return clauses <= limit_;
+        }
+        case Kind::Distinct: {
+            if (atom.atom() == 0 || atom.guard() || !unconditional()) { break; }
+            std::vector<Linear> elems(atom.size());
+            bool ok = true;
+            auto it = elems.begin();
+            for (auto &&elemId : atom) { ok = ok && parse(*theory_.getElement(elemId).begin(), 1, *it++); }
+            if (!ok) { break; }
+            for (auto &e : elems) {
+                e.simplify();
+                addVars(e);
+                for (auto &f : elems) {
+                    if (&f == &e) { break; }
+                    Linear d = e;
+                    for (auto &t : f.terms) { d.terms.emplace_back(t.first, -t.second); }
+                    d.simplify();
+                    clauses = std::min<uint64_t>(clauses + 4 * estimate(d), uint64_t(limit_) + 1);
+                }
+            }
+            return clauses <= limit_;
+        }
+        case Kind::Minimize: {
+            if (atom.atom() != 0 || atom.guard() || !unconditional()) { break; }
+            bool ok = true;
+            for (auto &&elemId : atom) {
+                Id_t w = *theory_.getElement(elemId).begin();
+                auto &&term = theory_.getTerm(w);
+                if (term.type() == Theory_t::Compound && term.isFunction() && term.size() == 2 && isSymbol(term.function(), "@")) {
+                    ok = ok && theory_.getTerm(*(term.begin() + 1)).type() == Theory_t::Number;
+                    w = *term.begin();
+                }
+                Linear lin;
+                ok = ok && parse(w, 1, lin);
+                lin.simplify();
+                addVars(lin);
+                // the weights of the order literals have to fit into an int
+                for (auto &t : lin.terms) {
+                    auto var = vars_.find(t.first);
+                    if (var == vars_.end() || var->second.values.empty()) { continue; }
+                    auto &values = var->second.values;
+                    int64_t range = int64_t(values.back()) - values.front();
+                    if (range * std::abs(t.second) > std::numeric_limits<int>::max()) { ok = false; }
+                }
+            }
+            if (!ok) { break; }
+            return true;
+        }
+        default: { break; }
+    }
+    c.vars.clear();
+    collectAll();
+    return false;
+}
+
+void EagerEncoder::printVariable(std::ostream &out, Id_t termId) const {
+    auto &&term = theory_.getTerm(termId);
+    switch (term.type()) {
+        case Theory_t::Number: { out << term.number(); break; }
+        case Theory_t::Symbol: { out << term.symbol(); break; }
+        case Theory_t::Compound: {
+            auto &parens = Tuple_t::parens(term.isTuple() ? term.tuple() : Tuple_t::Paren);
+            if (term.isFunction()) { printVariable(out, term.function()); }
+            out << parens.first;
+            bool comma = false;
+            for (auto &&t : term) {
+                if (comma) { out << ","; }
+                else       { comma = true; }
+                printVariable(out, t);
+            }
+            if (term.isTuple() && term.tuple() == TupleType::Paren && term.size() == 1) { out << ","; }
+            out << parens.second;
+            break;
+        }
+    }
+}
+
+Atom_t EagerEncoder::newAtom() {
+    return (*next_)++;
+}
+
+Lit_t EagerEncoder::top() {
+    if (!true_) {
+        Atom_t a = newAtom();
+        auto &atoms = out_.tempAtoms();
+        atoms.emplace_back(a);
+        out_.printHead(false, atoms);
+        out_.printNormalBody(out_.tempLits());
+        true_ = lit(a);
+    }
+    return true_;
+}
+
+void EagerEncoder::choice(Atom_t atom) {
+    auto &atoms = out_.tempAtoms();
+    atoms.emplace_back(atom);
+    out_.printHead(true, atoms);
+    out_.printNormalBody(out_.tempLits());
+}
+
+void EagerEncoder::clause(std::vector<Lit_t> const &lits) {
+    out_.printHead(false, out_.tempAtoms());
+    auto &body = out_.tempLits();
+    for (auto &l : lits) { body.emplace_back(-l); }
+    out_.printNormalBody(body);
+}
+
+void EagerEncoder::encode(Variable &var) {
+    // :- q_i, not q_i+1.
+    for (size_t i = 0; i + 1 < var.values.size(); ++i) {
+        Atom_t a = newAtom();
+        choice(a);
+        var.order.emplace_back(lit(a));
+        if (i > 0) { clause({-var.order[i - 1], var.order[i]}); }
+    }
+    if (var.values.empty()) { clause({}); }
+}
+
+void EagerEncoder::encodeLE(Linear const &lin, int64_t bound, Lit_t cond) {
+    // cond -> lin <= bound
+    std::vector<View> views;
+    for (auto &t : lin.terms) {
+        auto &var = vars_.find(t.first)->second;
+        // Note: the program is inconsistent anyway
+        if (var.values.empty()) { return; }
+        views.push_back(View{&var, t.second, 0, 0});
+    }
+    std::sort(views.begin(), views.end(), [](View const &a, View const &b) { return a.size() < b.size(); });
+    for (size_t i = views.size(); i-- > 1; ) {
+        views[i - 1].minRest = views[i].minRest + views[i].value(0);
+        views[i - 1].maxRest = views[i].maxRest + views[i].value(views[i].size() - 1);
+    }
+    std::vector<Lit_t> lits{-cond};
+    bound-= lin.fixed;
+    if (views.empty()) {
+        if (bound < 0) { clause(lits); }
+        return;
+    }
+    encodeLE(views, 0, 0, bound, lits);
+}
+
+void EagerEncoder::encodeLE(std::vector<View> const &views, size_t i, int64_t sum, int64_t bound, std::vector<Lit_t> &lits) {
+    // Note: each clause excludes the assignments where the views take at least
+    //       the current values and these already exceed the bound
+    auto &v = views[i];
+    if (i + 1 == views.size()) {
+        size_t lo = 0, hi = v.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (sum + v.value(mid) > bound) { hi = mid; }
+            else                            { lo = mid + 1; }
+        }
+        if (lo == v.size()) { return; }
+        if (lo > 0) { lits.emplace_back(-v.ge(lo)); }
+        clause(lits);
+        if (lo > 0) { lits.pop_back(); }
+        return;
+    }
+    for (size_t j = 0; j < v.size(); ++j) {
+        int64_t s = sum + v.value(j);
+        if (s + v.maxRest <= bound) { continue; }
+        if (j > 0) { lits.emplace_back(-v.ge(j)); }
+        bool done = s + v.minRest > bound;
+        if (done) { clause(lits); }
+        else      { encodeLE(views, i + 1, s, bound, lits); }
+        if (j > 0) { lits.pop_back(); }
+        if (done) { break; }
+    }
+}
+
+void EagerEncoder::encodeRel(Linear const &lin, char const *rel, Lit_t r) {
+    // r <=> lin rel 0
+    Linear neg = lin.negated();
+    if (std::strcmp(rel, "<=") == 0) {
+        encodeLE(lin, 0, r);
+        encodeLE(neg, -1, -r);
+    }
+    else if (std::strcmp(rel, ">=") == 0) {
+        encodeLE(neg, 0, r);
+        encodeLE(lin, -1, -r);
+    }
+    else if (std::strcmp(rel, "<") == 0) {
+        encodeLE(lin, -1, r);
+        encodeLE(neg, 0, -r);
+    }
+    else if (std::strcmp(rel, ">") == 0) {
+        encodeLE(neg, -1, r);
+        encodeLE(lin, 0, -r);
+    }
+    else {
+        // r <=> a & b or r <=> ~(a & b) where a <=> lin <= 0 and b <=> lin >= 0
+        // Note: the auxiliary atoms are reified in both directions to not introduce additional answer sets
+        Atom_t a = newAtom(), b = newAtom();
+        choice(a);
+        choice(b);
+        encodeRel(lin, "<=", lit(a));
+        encodeRel(lin, ">=", lit(b));
+        Lit_t eq = std::strcmp(rel, "!=") == 0 ? -r : r;
+        clause({-eq, lit(a)});
+        clause({-eq, lit(b)});
+        clause({eq, -lit(a), -lit(b)});
+    }
+}
+
+void EagerEncoder::encodeSum(TheoryAtom const &atom) {
+    Linear lin;
+    parse(*atom.rhs(), -1, lin);
+    for (auto &&elemId : atom) { parse(*theory_.getElement(elemId).begin(), 1, lin); }
+    lin.simplify();
+    choice(atom.atom());
+    encodeRel(lin, theory_.getTerm(*atom.guard()).symbol(), lit(atom.atom()));
+}
+
+void EagerEncoder::encodeDistinct(TheoryAtom const &atom) {
+    // r <=> p_1 & ... & p_n where each p_i is reified with a pairwise disequality
+    Lit_t r = lit(atom.atom());
+    choice(atom.atom());
+    std::vector<Linear> elems(atom.size());
+    auto it = elems.begin();
+    for (auto &&elemId : atom) { parse(*theory_.getElement(elemId).begin(), 1, *it++); }
+    std::vector<Lit_t> all{r};
+    for (auto &e : elems) {
+        for (auto &f : elems) {
+            if (&f == &e) { break; }
+            Linear d = e;
+            for (auto &t : f.terms) { d.terms.emplace_back(t.first, -t.second); }
+            d.fixed-= f.fixed;
+            d.simplify();
+            Atom_t p = newAtom();
+            choice(p);
+            encodeRel(d, "!=", lit(p));
+            clause({-r, lit(p)});
+            all.emplace_back(-lit(p));
+        }
+    }
+    clause(all);
+}
+
+void EagerEncoder::encodeMinimize(TheoryAtom const &atom) {
+    // a view c*x contributes c*min(x) plus the differences between consecutive values
+    // weighted with the order literals; constants are attached to a true literal
+    std::map<int, std::vector<WeightLit_t>> levels;
+    for (auto &&elemId : atom) {
+        Id_t w = *theory_.getElement(elemId).begin();
+        int prio = 0;
+        auto &&term = theory_.getTerm(w);
+        if (term.type() == Theory_t::Compound && term.isFunction() && term.size() == 2 && isSymbol(term.function(), "@")) {
+            prio = theory_.getTerm(*(term.begin() + 1)).number();
+            w = *term.begin();
+        }
+        Linear lin;
+        parse(w, 1, lin);
+        lin.simplify();
+        auto &lits = levels[prio];
+        int64_t fixed = lin.fixed;
+        for (auto &t : lin.terms) {
+            auto &var = vars_.find(t.first)->second;
+            auto &values = var.values;
+            if (values.empty()) { continue; }
+            int64_t c = t.second;
+            if (c > 0) {
+                fixed+= c * values.front();
+                for (size_t i = 1; i < values.size(); ++i) {
+                    lits.push_back({-var.order[i - 1], static_cast<Weight_t>(c * (int64_t(values[i]) - values[i - 1]))});
+                }
+            }
+            else {
+                fixed+= c * values.back();
+                for (size_t i = 0; i + 1 < values.size(); ++i) {
+                    lits.push_back({var.order[i], static_cast<Weight_t>(-c * (int64_t(values[i + 1]) - values[i]))});
+                }
+            }
+        }
+        if (fixed != 0) { lits.push_back({top(), static_cast<Weight_t>(fixed)}); }
+    }
+    for (auto &level : levels) {
+        auto &lits = out_.tempWLits();
+        lits.assign(level.second.begin(), level.second.end());
+        out_.printMinimize(level.first, lits);
+    }
+}
+
+void EagerEncoder::encodeShow(TheoryAtom const &atom, Gringo::Output::Backend::GetCond const &getCond, std::vector<Id_t> &lazy) {
+    // x=v :- C, x <= v, not x <= v-1.
+    for (auto &&elemId : atom) {
+        auto &&elem = theory_.getElement(elemId);
+        auto it = elem.size() == 1 ? vars_.find(*elem.begin()) : vars_.end();
+        if (it == vars_.end() || !it->second.eager) {
+            lazy.emplace_back(elemId);
+            continue;
+        }
+        auto &var = it->second;
+        std::ostringstream oss;
+        printVariable(oss, *elem.begin());
+        oss << "=";
+        std::string name = oss.str();
+        auto cond = getCond(elemId);
+        for (size_t i = 0; i < var.values.size(); ++i) {
+            auto &body = out_.tempLits();
+            body.assign(cond.begin(), cond.end());
+            if (i + 1 < var.values.size()) { body.emplace_back(var.order[i]); }
+            if (i > 0)                      { body.emplace_back(-var.order[i - 1]); }
+            out_.printOutput((name + std::to_string(var.values[i])).c_str(), body);
+        }
+    }
+}
+
+EagerEncoder::AtomVec EagerEncoder::encode(AtomVec const &atoms, Atom_t &next, Gringo::Output::Backend::GetCond const &getCond) {
+    // Outline:
+    // - variables with a small domain declaration are candidates for the encoding
+    // - constraints that cannot be encoded make all their variables lazy
+    //   until a fixpoint is reached
+    // - the remaining variables and constraints are encoded
+    next_ = &next;
+    AtomVec lazy, shows;
+    std::vector<std::pair<Id_t, TheoryAtom const *>> doms;
+    std::vector<Constraint> constraints;
+    for (auto &atom : atoms) {
+        Kind k = kind(*atom);
+        if (k == Kind::Dom && atom->rhs()) {
+            std::vector<int> values;
+            bool ok = parseDom(*atom, values);
+            auto &var = vars_[*atom->rhs()];
+            if (++var.doms > 1 || !ok) { var.eager = false; }
+            else                       { var.values = std::move(values); }
+            doms.emplace_back(*atom->rhs(), atom);
+        }
+        else if (k == Kind::Show) { shows.emplace_back(atom); }
+        else                      { constraints.push_back({atom, k, {}, false}); }
+    }
+    for (auto &c : constraints) { c.eager = analyze(c); }
+    auto isLazy = [this](Id_t v) {
+        auto it = vars_.find(v);
+        return it == vars_.end() || !it->second.eager;
+    };
+    auto demote = [this](Constraint &c) {
+        c.eager = false;
+        for (auto &v : c.vars) {
+            auto it = vars_.find(v);
+            if (it != vars_.end()) { it->second.eager = false; }
+        }
+    };
+    for (auto &c : constraints) {
+        if (!c.eager) { demote(c); }
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (auto &c : constraints) {
+            if (c.eager && std::any_of(c.vars.begin(), c.vars.end(), isLazy)) {
+                demote(c);
+                changed = true;
+            }
+        }
+    }
+    for (auto &dom : doms) {
+        auto &var = vars_[dom.first];
+        if (var.eager) { encode(var); }
+        else           { lazy.emplace_back(dom.second); }
+    }
+    for (auto &c : constraints) {
+        if (!c.eager) {
+            lazy.emplace_back(c.atom);
+            continue;
+        }
+        switch (c.kind) {
+            case Kind::Sum:      { encodeSum(*c.atom); break; }
+            case Kind::Distinct: { encodeDistinct(*c.atom); break; }
+            case Kind::Minimize: { encodeMinimize(*c.atom); break; }
+            default:             { assert(false); break; }
+        }
+    }
+    // Note: only shown variables are printed, so show atoms without elements can be dropped
+    for (auto &atom : shows) {
+        std::vector<Id_t> elems;
+        encodeShow(*atom, getCond, elems);
+        if (elems.size() == atom->size()) {
+            if (!elems.empty()) { lazy.emplace_back(atom); }
+        }
+        else if (!elems.empty()) {
+            lazy.emplace_back(&data_.addAtom([]() { return 0; }, atom->occurrence(), atom->term(), toSpan(elems)).first);
+        }
+    }
+    return lazy;
+}
+
+// }}}1
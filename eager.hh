@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2015, Anonymous Author (temporary)
+//
+// This file is part of lc2casp. See https://github.com/lc2casp/lc2casp
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef LIBFOUNDED_EAGER_H_INCLUDED
+#define LIBFOUNDED_EAGER_H_INCLUDED
+#include <potassco/basic_types.h>
+#include <potassco/theory_data.h>
+#include <gringo/output/theory.hh>
+#include <gringo/output/backend.hh>
+#include <unordered_map>
+#include <vector>
+
+// Order encodes integer variables with small domains and the constraints over
+// them as plain rules, in the spirit of clingcon's translation of constraints
+// into clauses.
+//
+// A variable is encoded if its domain declaration has at most limit values and
+// a sum, distinct, or minimize atom is encoded if all its variables are encoded
+// and the estimated number of clauses does not exceed limit. Everything else,
+// including the variables of such atoms, is passed on to the constraint solver.
+class EagerEncoder {
+public:
+    using AtomVec = std::vector<Potassco::TheoryAtom const *>;
+    EagerEncoder(Gringo::Output::Backend &out, Gringo::Output::TheoryData &data, unsigned limit);
+    EagerEncoder(const EagerEncoder&) = delete;
+    EagerEncoder& operator=(const EagerEncoder&) = delete;
+    ~EagerEncoder() noexcept;
+    // Encodes the given theory atoms where possible, introducing fresh atoms
+    // starting from next, and returns the theory atoms that remain.
+    AtomVec encode(AtomVec const &atoms, Potassco::Atom_t &next, Gringo::Output::Backend::GetCond const &getCond);
+private:
+    struct Linear;
+    struct Variable;
+    struct View;
+    enum class Kind { Dom, Show, Sum, Distinct, Minimize, Other };
+    struct Constraint {
+        Potassco::TheoryAtom const *atom;
+        Kind kind;
+        std::vector<Potassco::Id_t> vars;
+        bool eager;
+    };
+    using VariableMap = std::unordered_map<Potassco::Id_t, Variable>;
+
+    Kind kind(Potassco::TheoryAtom const &atom) const;
+    bool isSymbol(Potassco::Id_t termId, char const *name) const;
+    bool parse(Potassco::Id_t termId, int64_t factor, Linear &lin) const;
+    bool parseDom(Potassco::TheoryAtom const &atom, std::vector<int> &values) const;
+    void collect(Potassco::Id_t termId, std::vector<Potassco::Id_t> &vars) const;
+    bool analyze(Constraint &c) const;
+    uint64_t estimate(Linear const &lin) const;
+    void printVariable(std::ostream &out, Potassco::Id_t termId) const;
+
+    Potassco::Atom_t newAtom();
+    Potassco::Lit_t top();
+    void choice(Potassco::Atom_t atom);
+    void clause(std::vector<Potassco::Lit_t> const &lits);
+    void encode(Variable &var);
+    void encodeLE(Linear const &lin, int64_t bound, Potassco::Lit_t cond);
+    void encodeLE(std::vector<View> const &views, size_t i, int64_t sum, int64_t bound, std::vector<Potassco::Lit_t> &clause);
+    void encodeRel(Linear const &lin, char const *rel, Potassco::Lit_t r);
+    void encodeSum(Potassco::TheoryAtom const &atom);
+    void encodeDistinct(Potassco::TheoryAtom const &atom);
+    void encodeMinimize(Potassco::TheoryAtom const &atom);
+    void encodeShow(Potassco::TheoryAtom const &atom, Gringo::Output::Backend::GetCond const &getCond, std::vector<Potassco::Id_t> &lazy);
+
+    Gringo::Output::Backend &out_;
+    Gringo::Output::TheoryData &data_;
+    Potassco::TheoryData const &theory_;
+    VariableMap vars_;
+    Potassco::Atom_t *next_ = nullptr;
+    Potassco::Lit_t true_ = 0;
+    unsigned limit_;
+};
+
+#endif
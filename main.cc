@@ -19,12 +19,24 @@
 #include "translator.hh"
 #include "printer.hh"
 #include "aspifc.hh"
+#include "cache.hh"
+#include "split.hh"
+#include <gringo/output/backends.hh>
 #include <potassco/convert.h>
 #include <program_opts/application.h>
 #include <program_opts/typed_value.h>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <cctype>
+#include <iterator>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <cerrno>
+#include <sys/stat.h>
 
 using namespace ProgramOptions;
 
@@ -35,8 +47,9 @@ public:
     virtual PosOption   getPositional() const { return &positional; }
     virtual const char* getUsage()      const {
         return
-            "[options] [<file>]\n"
-            "Translate program in <file> or standard input";
+            "[options] [<file>...]\n"
+            "Translate program in <file> or standard input\n"
+            "Several files are translated in batch mode (see --output-dir)";
     }
     virtual void initOptions(OptionContext& root);
     virtual void validateOptions(const OptionContext&, const ParsedOptions&, const ParsedValues&) {}
@@ -52,53 +65,363 @@ private:
         static_cast<LpConvert*>(Application::getInstance())->exit(EXIT_FAILURE);
         return EXIT_FAILURE;
     }
-    std::string input_;
+    static int raise(int line, const char* what) {
+        std::ostringstream msg;
+        msg << "In line " << line << ": " << what;
+        throw std::runtime_error(msg.str());
+    }
+    void readBounds(FoundedOutput &out) const;
+    void readWarmStart(FoundedOutput &out) const;
+    void translate(std::istream &in, std::ostream &os, Potassco::ErrorHandler err) const;
+    void process(std::istream &in, std::ostream &os, TranslationCache *cache, Potassco::ErrorHandler err) const;
+    void runBatch(StringSeq const &inputs, TranslationCache *cache);
+    void runSplit(std::istream &in, TranslationCache *cache) const;
+    std::string options() const;
+    StringSeq input_;
     std::string output_;
+    std::string outputDir_;
+    std::string manifest_;
+    std::string splitDir_;
+    unsigned jobs_ = 1;
+    std::string boundsFile_;
+    std::string warmStartFile_;
+    std::string provenanceFile_;
+    unsigned project_ = 0;
+    std::string cacheDir_;
+    unsigned cacheSize_ = 1024;
     std::pair<int, int> bound_ = {std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
     bool text_ = false;
+    bool symmetries_ = false;
+    unsigned eager_ = 0;
+    bool objectiveBounds_ = false;
+    bool dropUnused_ = false;
+    FoundedOutput::Heuristic heuristic_ = FoundedOutput::Heuristic::None;
 };
 
 void LpConvert::initOptions(OptionContext& root) {
     OptionGroup convert("Options");
     convert.addOptions()
-        ("input,i,@2", storeTo(input_), "Input file")
+        ("input,i,@2", storeTo(input_)->composing(), "Input files")
         ("text,t", storeTo(text_)->flag(), "Do not translate but print the input in something more readable")
         ("bounds,b", storeTo(bound_), "Pair of values limiting the minimum and maximum value for integer variables")
+        ("bounds-file", storeTo(boundsFile_)->arg("<file>"), "Read bounds for individual variables from <file>\n"
+            "      Each line has form <name>/<arity> <min> <max> or <term> <min> <max>")
+        ("break-symmetries", storeTo(symmetries_)->flag(), "Order the values of interchangeable variables\n"
+            "      Note: this changes the enumerated solutions")
+        ("eager", storeTo(eager_)->arg("<n>"), "Order encode variables with at most <n> values and constraints\n"
+            "      needing at most <n> clauses as plain rules (default: 0, off)\n"
+            "      Note: the output is plain aspif if everything is encoded")
+        ("bound-objective", storeTo(objectiveBounds_)->flag(), "Bound the objective of each minimize priority level\n"
+            "      by the variable domains using redundant constraints")
+        ("drop-unused", storeTo(dropUnused_)->flag(), "Drop assignments of variables that are neither shown\n"
+            "      nor used in constraints\n"
+            "      Note: this changes the enumerated solutions")
+        ("heuristic", storeTo(heuristic_, values<FoundedOutput::Heuristic>()
+            ("none", FoundedOutput::Heuristic::None)
+            ("sign", FoundedOutput::Heuristic::Sign)
+            ("level", FoundedOutput::Heuristic::Level)
+            ("factor", FoundedOutput::Heuristic::Factor)), "Emit #heuristic directives for the introduced atoms (default: none)\n"
+            "      sign  : prefer defining variables and choosing assignments\n"
+            "      level : additionally decide assignments with small domains first\n"
+            "      factor: additionally score assignments with small domains higher\n"
+            "      Note: requires a solver with domain heuristic, e.g., --heuristic=domain")
+        ("warm-start", storeTo(warmStartFile_)->arg("<file>"), "Prefer the solution in <file> using #heuristic directives\n"
+            "      The file holds shown atoms and values <term>=<value> as printed\n"
+            "      by clingcon; of a solver output, the last answer is used\n"
+            "      Note: requires a solver with domain heuristic, e.g., --heuristic=domain")
+        ("project", storeTo(project_)->arg("<n>")->implicit("1000"), "Project solutions onto shown atoms and variables\n"
+            "      with at most <n> values each (implicit: 1000, default: 0, off)\n"
+            "      Note: each value of a shown variable adds a theory atom;\n"
+            "            requires a solver with projective enumeration, e.g., --project")
+        ("provenance", storeTo(provenanceFile_)->arg("<file>"), "Write the origin of each atom introduced by the translation\n"
+            "      to <file>, one JSON object per line")
         ("output,o", storeTo(output_)->arg("<file>"), "Write output to <file> (default: stdout)")
+        ("output-dir", storeTo(outputDir_)->arg("<dir>"), "Translate all inputs writing outputs with the same file names to <dir>")
+        ("manifest", storeTo(manifest_)->arg("<file>"), "Read additional input files from <file>, one per line")
+        ("split", storeTo(splitDir_)->arg("<dir>"), "Write one program per independent component to <dir>\n"
+            "      and list them in <dir>/manifest; the answer sets of the program\n"
+            "      are the combinations of one answer set per component")
+        ("jobs,j", storeTo(jobs_)->arg("<n>"), "Translate up to <n> files in parallel in batch mode")
+        ("cache", storeTo(cacheDir_)->arg("<dir>"), "Reuse translations of previously seen programs stored in <dir>")
+        ("cache-size", storeTo(cacheSize_)->arg("<n>"), "Limit the size of the cache to <n> MiB (default: 1024)")
     ;
     root.add(convert);
 }
-void LpConvert::run() {
-    std::ifstream iFile;
-    std::ofstream oFile;
-    if (!input_.empty() && input_ != "-") {
-        iFile.open(input_.c_str());
-        if (!iFile.is_open()) { throw std::runtime_error("Could not open input file!"); }
+void LpConvert::readBounds(FoundedOutput &out) const {
+    std::ifstream in(boundsFile_.c_str());
+    if (!in.is_open()) { throw std::runtime_error("Could not open bounds file!"); }
+    std::string line;
+    for (int lineNum = 1; std::getline(in, line); ++lineNum) {
+        std::istringstream iss(line);
+        std::vector<std::string> tokens;
+        for (std::string token; iss >> token; ) { tokens.emplace_back(std::move(token)); }
+        if (tokens.empty() || tokens.front().front() == '%') { continue; }
+        int min, max;
+        std::string pattern;
+        for (auto it = tokens.begin(), ie = tokens.end() - std::min<size_t>(tokens.size(), 2); it != ie; ++it) { pattern+= *it; }
+        if (pattern.empty() || !bk_lib::string_cast(tokens[tokens.size() - 2], min) || !bk_lib::string_cast(tokens.back(), max) || min > max) {
+            std::ostringstream msg;
+            msg << "In line " << lineNum << ": invalid bound in bounds file";
+            throw std::runtime_error(msg.str());
+        }
+        auto slash = pattern.rfind('/');
+        int arity;
+        if (slash != std::string::npos && slash > 0 && pattern.find('(') == std::string::npos && bk_lib::string_cast(pattern.substr(slash + 1), arity) && arity >= 0) {
+            out.addBound(pattern.substr(0, slash), arity, min, max);
+        }
+        else {
+            out.addBound(pattern, min, max);
+        }
     }
-    if (!output_.empty() && output_ != "-") {
-        if (input_ == output_) { throw std::runtime_error("Input and output must be different!"); }
-        oFile.open(output_.c_str());
-        if (!oFile.is_open()) { throw std::runtime_error("Could not open output file!"); }
+}
+
+void LpConvert::readWarmStart(FoundedOutput &out) const {
+    std::ifstream in(warmStartFile_.c_str());
+    if (!in.is_open()) { throw std::runtime_error("Could not open warm start file!"); }
+    // Note: if the file is the output of a solver, only the line after the last answer header is used
+    std::vector<std::string> lines;
+    bool answer = false;
+    for (std::string line; std::getline(in, line); ) {
+        if (line.compare(0, 7, "Answer:") == 0) {
+            if (!std::getline(in, line)) { break; }
+            lines.assign(1, line);
+            answer = true;
+        }
+        else if (!answer) { lines.emplace_back(std::move(line)); }
     }
-    std::istream& in = iFile.is_open() ? iFile : std::cin;
-    std::ostream& os = oFile.is_open() ? oFile : std::cout;
+    out.enableWarmStart(true);
+    for (auto &&line : lines) {
+        std::istringstream iss(line);
+        for (std::string token; iss >> token; ) {
+            auto eq = token.rfind('=');
+            int value;
+            if (eq != std::string::npos && eq > 0 && bk_lib::string_cast(token.substr(eq + 1), value)) {
+                out.addInitialValue(token.substr(0, eq), value);
+            }
+            else {
+                out.addInitialAtom(token);
+            }
+        }
+    }
+}
+
+std::string LpConvert::options() const {
+    std::ostringstream oss;
+    oss << getName() << " " << getVersion() << " " << text_ << " " << bound_.first << " " << bound_.second << " " << symmetries_ << " " << eager_ << " " << objectiveBounds_ << " " << dropUnused_ << " " << static_cast<int>(heuristic_) << " " << project_ << "\n";
+    // Note: file contents are tagged and prefixed with their length
+    //       so that different combinations of files cannot yield the same key
+    auto addFile = [&oss](char const *tag, std::string const &file, char const *message) {
+        if (file.empty()) { return; }
+        std::ifstream in(file.c_str());
+        if (!in.is_open()) { throw std::runtime_error(message); }
+        std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        oss << tag << " " << content.size() << "\n" << content;
+    };
+    addFile("bounds", boundsFile_, "Could not open bounds file!");
+    addFile("warm-start", warmStartFile_, "Could not open warm start file!");
+    return oss.str();
+}
+
+void LpConvert::translate(std::istream &in, std::ostream &os, Potassco::ErrorHandler err) const {
     if (in.peek() == 'a') {
         ConditionVec conditions;
         Potassco::TheoryData data;
-        if (text_) {
+        auto start = in.tellg();
+        if (text_ && start != std::istream::pos_type(-1)) {
+            // Note: seekable inputs are printed in two passes to avoid buffering the whole program;
+            //       the first pass indexes theory atoms and named outputs, which the second one uses
+            Printer writer(os, conditions, data);
+            writer.setMode(Printer::Mode::Index);
+            {
+                AspifCInput reader(writer, conditions, data);
+                readProgram(in, reader, err);
+            }
+            in.clear();
+            in.seekg(start);
+            ConditionVec streamConditions;
+            Potassco::TheoryData streamData;
+            writer.setMode(Printer::Mode::Stream);
+            AspifCInput reader(writer, streamConditions, streamData);
+            readProgram(in, reader, err);
+        }
+        else if (text_) {
             Printer writer(os, conditions, data);
             AspifCInput reader(writer, conditions, data);
-            readProgram(in, reader, error);
+            readProgram(in, reader, err);
         }
         else {
-            FoundedOutput writer(os, conditions, data, bound_.first, bound_.second);
+            Potassco::TheoryData outData;
+            Gringo::Output::IntermediateFormatBackend backend(outData, os);
+            FoundedOutput writer(backend, outData, conditions, data, bound_.first, bound_.second);
+            if (!boundsFile_.empty()) { readBounds(writer); }
+            if (!warmStartFile_.empty()) { readWarmStart(writer); }
+            std::ofstream provenance;
+            if (!provenanceFile_.empty()) {
+                provenance.open(provenanceFile_.c_str());
+                if (!provenance.is_open()) { throw std::runtime_error("Could not open provenance file!"); }
+                writer.enableProvenance(&provenance);
+            }
+            writer.enableSymmetryBreaking(symmetries_);
+            writer.enableEager(eager_);
+            writer.enableObjectiveBounds(objectiveBounds_);
+            writer.enableUnusedElimination(dropUnused_);
+            writer.enableHeuristic(heuristic_);
+            writer.enableProjection(project_);
             AspifCInput reader(writer, conditions, data);
-            readProgram(in, reader, error);
+            readProgram(in, reader, err);
         }
     }
     else {
         throw std::runtime_error("Unrecognized input format!");
     }
+}
+
+void LpConvert::process(std::istream &in, std::ostream &os, TranslationCache *cache, Potassco::ErrorHandler err) const {
+    if (cache) {
+        // Note: the whole program has to be hashed before it can be translated
+        std::string program{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        auto key = TranslationCache::hash(program, TranslationCache::hash(options()));
+        if (!cache->load(key, os)) {
+            std::istringstream iss(program);
+            std::ostringstream out;
+            translate(iss, out, err);
+            std::string translation = out.str();
+            os.write(translation.data(), translation.size());
+            // Note: if another writer interferes, the translation is simply not cached
+            cache->store(key, translation);
+        }
+    }
+    else {
+        translate(in, os, err);
+    }
+}
+
+void LpConvert::runBatch(StringSeq const &inputs, TranslationCache *cache) {
+    if (outputDir_.empty()) { throw std::runtime_error("Batch mode requires an output directory!"); }
+    if (mkdir(outputDir_.c_str(), 0777) != 0 && errno != EEXIST) { throw std::runtime_error("Could not create output directory!"); }
+    StringSeq outputs;
+    std::unordered_set<std::string> seen;
+    for (auto &&input : inputs) {
+        auto slash = input.rfind('/');
+        outputs.emplace_back(outputDir_ + "/" + (slash != std::string::npos ? input.substr(slash + 1) : input));
+        if (!seen.emplace(outputs.back()).second) { throw std::runtime_error("Input files must have distinct names in batch mode!"); }
+    }
+    struct Result {
+        double time = 0;
+        bool failed = false;
+    };
+    std::vector<Result> results(inputs.size());
+    std::atomic<size_t> next(0);
+    std::mutex errorMut;
+    auto work = [&]() {
+        for (size_t i; (i = next++) < inputs.size(); ) {
+            auto start = std::chrono::steady_clock::now();
+            try {
+                std::ifstream in(inputs[i].c_str());
+                if (!in.is_open()) { throw std::runtime_error("Could not open input file!"); }
+                if (inputs[i] == outputs[i]) { throw std::runtime_error("Input and output must be different!"); }
+                std::ofstream out(outputs[i].c_str());
+                if (!out.is_open()) { throw std::runtime_error("Could not open output file!"); }
+                process(in, out, cache, raise);
+                out.close();
+                if (!out) { throw std::runtime_error("Could not write output file!"); }
+            }
+            catch (std::exception const &e) {
+                results[i].failed = true;
+                std::remove(outputs[i].c_str());
+                std::lock_guard<std::mutex> lock(errorMut);
+                fprintf(stderr, "*** ERROR: %s: %s\n", inputs[i].c_str(), e.what());
+            }
+            results[i].time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned j = 1; j < std::min<size_t>(jobs_, inputs.size()); ++j) { workers.emplace_back(work); }
+    work();
+    for (auto &&worker : workers) { worker.join(); }
+    size_t failed = 0, slowest = 0;
+    double total = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        failed += results[i].failed;
+        total += results[i].time;
+        if (results[i].time > results[slowest].time) { slowest = i; }
+    }
+    fprintf(stderr, "Files    : %zu (%zu failed)\n", inputs.size(), failed);
+    if (!inputs.empty()) {
+        fprintf(stderr, "Time     : %.3fs (Average: %.3fs Max: %.3fs in %s)\n", total, total / inputs.size(), results[slowest].time, inputs[slowest].c_str());
+    }
+    if (failed > 0) { setExitCode(EXIT_FAILURE); }
+}
+
+void LpConvert::runSplit(std::istream &in, TranslationCache *cache) const {
+    if (text_) { throw std::runtime_error("Splitting requires aspif output!"); }
+    if (mkdir(splitDir_.c_str(), 0777) != 0 && errno != EEXIST) { throw std::runtime_error("Could not create split directory!"); }
+    std::stringstream program;
+    process(in, program, cache, error);
+    ConditionVec conditions;
+    Potassco::TheoryData data;
+    Splitter splitter(conditions, data);
+    {
+        AspifCInput reader(splitter, conditions, data);
+        readProgram(program, reader, raise);
+    }
+    std::ofstream manifest((splitDir_ + "/manifest").c_str());
+    if (!manifest.is_open()) { throw std::runtime_error("Could not open manifest file!"); }
+    for (unsigned i = 0; i < splitter.components(); ++i) {
+        std::ostringstream name;
+        name << splitDir_ << "/component-" << i << ".aspif";
+        std::ofstream out(name.str().c_str());
+        if (!out.is_open()) { throw std::runtime_error("Could not open output file!"); }
+        out << splitter.program(i);
+        out.close();
+        if (!out) { throw std::runtime_error("Could not write output file!"); }
+        manifest << name.str() << "\n";
+    }
+    manifest.close();
+    if (!manifest) { throw std::runtime_error("Could not write manifest file!"); }
+    fprintf(stderr, "Components: %u\n", splitter.components());
+}
+
+void LpConvert::run() {
+    StringSeq inputs = input_;
+    if (!manifest_.empty()) {
+        std::ifstream in(manifest_.c_str());
+        if (!in.is_open()) { throw std::runtime_error("Could not open manifest file!"); }
+        for (std::string line; std::getline(in, line); ) {
+            if (!line.empty()) { inputs.emplace_back(std::move(line)); }
+        }
+    }
+    std::unique_ptr<TranslationCache> cache;
+    if (!cacheDir_.empty()) { cache.reset(new TranslationCache(cacheDir_, static_cast<uint64_t>(cacheSize_) << 20)); }
+    if (!splitDir_.empty() && (!outputDir_.empty() || !manifest_.empty() || inputs.size() > 1 || !output_.empty())) {
+        throw std::runtime_error("Splitting requires a single input and no other output!");
+    }
+    if (!provenanceFile_.empty() && (!outputDir_.empty() || !manifest_.empty() || inputs.size() > 1 || cache)) {
+        throw std::runtime_error("Provenance requires a single input and no cache!");
+    }
+    if (!outputDir_.empty() || !manifest_.empty() || inputs.size() > 1) {
+        runBatch(inputs, cache.get());
+        return;
+    }
+    std::string input = inputs.empty() ? "" : inputs.front();
+    std::ifstream iFile;
+    std::ofstream oFile;
+    if (!input.empty() && input != "-") {
+        iFile.open(input.c_str());
+        if (!iFile.is_open()) { throw std::runtime_error("Could not open input file!"); }
+    }
+    if (!splitDir_.empty()) {
+        runSplit(iFile.is_open() ? iFile : std::cin, cache.get());
+        return;
+    }
+    if (!output_.empty() && output_ != "-") {
+        if (input == output_) { throw std::runtime_error("Input and output must be different!"); }
+        oFile.open(output_.c_str());
+        if (!oFile.is_open()) { throw std::runtime_error("Could not open output file!"); }
+    }
+    std::istream& in = iFile.is_open() ? iFile : std::cin;
+    std::ostream& os = oFile.is_open() ? oFile : std::cout;
+    process(in, os, cache.get(), error);
     iFile.close();
     oFile.close();
 }
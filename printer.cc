@@ -77,45 +77,58 @@ public:
     , data_(data)
     , conditions_(conditions) { }
 
+    void setMode(Printer::Mode mode) {
+        mode_ = mode;
+    }
+    Printer::Mode mode() const {
+        return mode_;
+    }
     void add(Rule &&rule) {
-        rules_.emplace_back(std::move(rule));
+        add(rules_, std::move(rule));
     }
     void add(Minimize &&m) {
-        minimize_.emplace_back(std::move(m));
+        add(minimize_, std::move(m));
     }
     void add(Output &&output) {
+        if (mode_ == Printer::Mode::Stream) { return; }
         if (output.body.size() == 1 && output.body.front() > 0) {
             named_.emplace(output.body.front(), output.str);
         }
-        else {
+        else if (mode_ == Printer::Mode::Buffer) {
             output_.emplace_back(std::move(output));
         }
     }
     void add(Assume &&a) {
-        assume_.emplace_back(std::move(a));
+        add(assume_, std::move(a));
     }
     void add(Project &&a) {
-        project_.emplace_back(std::move(a));
+        add(project_, std::move(a));
     }
     void add(External &&a) {
-        external_.emplace_back(std::move(a));
+        add(external_, std::move(a));
     }
     void add(Heuristic &&a) {
-        heuristic_.emplace_back(std::move(a));
+        add(heuristic_, std::move(a));
     }
     void add(Acyc &&a) {
-        acyc_.emplace_back(std::move(a));
+        add(acyc_, std::move(a));
     }
-    void print() {
+    void index() {
         for (auto &a : data_) {
-            if (a->atom()) {
-                atoms_[a->atom()] = a;
-            }
-            else {
+            if (a->atom()) { atoms_[a->atom()] = a; }
+        }
+    }
+    void printDirectives() {
+        for (auto &a : data_) {
+            if (!a->atom()) {
                 print(*a);
                 out_ << ".\n";
             }
         }
+    }
+    void print() {
+        index();
+        printDirectives();
         for (auto &r : rules_) { print(r); }
         for (auto &m : minimize_) { print(m); }
         for (auto &a : assume_) { print(a); }
@@ -125,6 +138,14 @@ public:
         for (auto &a : acyc_) { print(a); }
     }
 private:
+    template <class T>
+    void add(std::vector<T> &vec, T &&x) {
+        switch (mode_) {
+            case Printer::Mode::Buffer: { vec.emplace_back(std::move(x)); break; }
+            case Printer::Mode::Stream: { print(x); break; }
+            case Printer::Mode::Index:  { break; }
+        }
+    }
     void print(Rule const &r) {
         if (r.headType == Head_t::Choice) {
             out_ << "{ ";
@@ -328,12 +349,18 @@ private:
     std::vector<Project> project_;
     std::unordered_map<Atom_t, std::string> named_;
     std::unordered_map<Atom_t, TheoryAtom const*> atoms_;
+    Printer::Mode mode_ = Printer::Mode::Buffer;
 };
 
 Printer::Printer(std::ostream& out, ConditionVec &conditions, TheoryData &data)
 : impl_(new Printer::Impl(out, conditions, data)) { }
 
+void Printer::setMode(Mode mode) {
+    impl_->setMode(mode);
+}
+
 void Printer::initProgram(bool) {
+    if (impl_->mode() == Mode::Stream) { impl_->printDirectives(); }
 }
 
 void Printer::beginStep() {
@@ -380,7 +407,11 @@ void Printer::heuristic(Atom_t a, Heuristic_t t, int bias, unsigned prio, const
 }
 
 void Printer::endStep() {
-    impl_->print();
+    switch (impl_->mode()) {
+        case Mode::Buffer: { impl_->print(); break; }
+        case Mode::Index:  { impl_->index(); break; }
+        case Mode::Stream: { break; }
+    }
 }
 
 Printer::~Printer() noexcept = default;
@@ -27,9 +27,14 @@ using ConditionVec = std::vector<std::vector<Potassco::Lit_t>>;
 class Printer : public Potassco::LpElement {
 public:
     class Impl;
+    // Buffer: collects the whole program and prints it at the end of a step
+    // Index:  only collects theory atoms and named outputs
+    // Stream: prints statements as they arrive using the index of a previous pass
+    enum class Mode { Buffer, Index, Stream };
     Printer(std::ostream& out, ConditionVec &conditions, Potassco::TheoryData &data);
     Printer(const Printer&) = delete;
     Printer& operator=(const Printer&) = delete;
+    void setMode(Mode mode);
     virtual void initProgram(bool);
     virtual void beginStep();
     virtual void rule(const Potassco::HeadView& head, const Potassco::BodyView& body);
@@ -0,0 +1,465 @@
+//
+// Copyright (c) 2015, Anonymous Author (temporary)
+//
+// This file is part of lc2casp. See https://github.com/lc2casp/lc2casp
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#include "split.hh"
+#include "aspifc.hh"
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace Potassco;
+
+namespace {
+
+struct Rule {
+    std::vector<Atom_t> head;
+    std::vector<WeightLit_t> body;
+    Head_t headType;
+    Body_t bodyType;
+    Weight_t bound;
+};
+
+struct Output {
+    std::string str;
+    std::vector<Lit_t> body;
+};
+
+struct Minimize {
+    Weight_t prio;
+    std::vector<WeightLit_t> body;
+};
+
+struct Assume {
+    std::vector<Lit_t> body;
+};
+
+struct External {
+    Atom_t a;
+    Value_t v;
+};
+
+struct Project {
+    std::vector<Atom_t> body;
+};
+
+struct Acyc {
+    int s;
+    int t;
+    std::vector<Lit_t> body;
+};
+
+struct Heuristic {
+    Atom_t a;
+    Heuristic_t t;
+    int bias;
+    unsigned prio;
+    std::vector<Lit_t> body;
+};
+
+struct Component {
+    Component(ConditionVec const &conditions)
+    : out(os, conditions) {
+        out.initProgram(false);
+        out.beginStep();
+    }
+    std::ostringstream os;
+    AspifCOutput out;
+    TheoryData data;
+    std::string program;
+};
+
+} // namespace
+
+class Splitter::Impl {
+public:
+    Impl(ConditionVec &conditions, TheoryData &data)
+    : data_(data)
+    , conditions_(conditions) { }
+
+    void add(Rule &&rule)        { rules_.emplace_back(std::move(rule)); }
+    void add(Minimize &&m)       { minimize_.emplace_back(std::move(m)); }
+    void add(Output &&output)    { output_.emplace_back(std::move(output)); }
+    void add(Assume &&a)         { assume_.emplace_back(std::move(a)); }
+    void add(Project &&a)        { project_.emplace_back(std::move(a)); }
+    void add(External &&a)       { external_.emplace_back(std::move(a)); }
+    void add(Heuristic &&a)      { heuristic_.emplace_back(std::move(a)); }
+    void add(Acyc &&a)           { acyc_.emplace_back(std::move(a)); }
+
+    unsigned components() const {
+        return components_.size();
+    }
+    std::string const &program(unsigned component) const {
+        return components_[component]->program;
+    }
+    void split() {
+        connect();
+        number();
+        for (size_t i = 0, n = std::max<size_t>(1, nontrivial_); i < n; ++i) {
+            components_.emplace_back(new Component(conditions_));
+        }
+        write();
+        for (auto &c : components_) {
+            c->out.theory(c->data);
+            c->out.endStep();
+            c->program = c->os.str();
+            c->os.str("");
+        }
+    }
+
+private:
+    // {{{2 union-find over atoms and the variables in theory atoms
+
+    unsigned newNode() {
+        parent_.emplace_back(parent_.size());
+        return parent_.back();
+    }
+    unsigned node(Atom_t atom) {
+        if (atom >= atomNodes_.size()) { atomNodes_.resize(atom + 1, 0); }
+        auto &n = atomNodes_[atom];
+        // Note: nodes are stored shifted by one so that zero marks atoms without a node
+        if (!n) { n = newNode() + 1; }
+        return n - 1;
+    }
+    unsigned varNode(Id_t termId) {
+        auto ret = varNodes_.emplace(termId, 0);
+        if (ret.second) { ret.first->second = newNode(); }
+        return ret.first->second;
+    }
+    unsigned find(unsigned n) {
+        while (parent_[n] != n) {
+            parent_[n] = parent_[parent_[n]];
+            n = parent_[n];
+        }
+        return n;
+    }
+    void unite(std::vector<unsigned> const &nodes) {
+        if (nodes.empty()) { return; }
+        unsigned a = find(nodes.front());
+        for (auto n : nodes) {
+            unsigned b = find(n);
+            if (a != b) { parent_[b] = a; }
+        }
+    }
+    bool isOp(Id_t funcId) const {
+        auto &&name = data_.getTerm(funcId);
+        char buf[2] = { *name.symbol(), 0 };
+        return std::strpbrk(buf, "/!<=>+-*\\?&@|:;~^.");
+    }
+    // Note: variables are symbols and non-operator functions;
+    //       operators and tuples are traversed
+    void collectVars(Id_t termId, std::vector<unsigned> &nodes) {
+        auto &&term = data_.getTerm(termId);
+        switch (term.type()) {
+            case Theory_t::Number: { break; }
+            case Theory_t::Symbol: { nodes.emplace_back(varNode(termId)); break; }
+            case Theory_t::Compound: {
+                if (term.isFunction() && !isOp(term.function())) {
+                    nodes.emplace_back(varNode(termId));
+                }
+                else {
+                    for (auto &&t : term) { collectVars(t, nodes); }
+                }
+                break;
+            }
+        }
+    }
+    void collectLits(std::vector<Lit_t> const &lits, std::vector<unsigned> &nodes) {
+        for (auto &&l : lits) { nodes.emplace_back(node(atom(l))); }
+    }
+    void collectElement(Id_t elemId, std::vector<unsigned> &nodes) {
+        auto &&elem = data_.getElement(elemId);
+        for (auto &&t : elem) { collectVars(t, nodes); }
+        if (elem.condition()) { collectLits(conditions_[elem.condition() - 1], nodes); }
+    }
+    void collectAtom(TheoryAtom const &atom, std::vector<unsigned> &nodes) {
+        if (atom.atom()) { nodes.emplace_back(node(atom.atom())); }
+        for (auto &&elemId : atom) { collectElement(elemId, nodes); }
+        if (atom.rhs()) { collectVars(*atom.rhs(), nodes); }
+    }
+    // Directives whose elements can be distributed over the components.
+    bool distributive(TheoryAtom const &atom) const {
+        auto &&term = data_.getTerm(atom.term());
+        return !atom.atom() && !atom.guard() && term.type() == Theory_t::Symbol &&
+            (std::strcmp(term.symbol(), "show") == 0 || std::strcmp(term.symbol(), "minimize") == 0);
+    }
+
+    void connect() {
+        std::vector<unsigned> nodes;
+        for (auto &r : rules_) {
+            nodes.clear();
+            for (auto &a : r.head) { nodes.emplace_back(node(a)); }
+            for (auto &l : r.body) { nodes.emplace_back(node(atom(l.lit))); }
+            unite(nodes);
+        }
+        for (auto &o : output_) {
+            nodes.clear();
+            collectLits(o.body, nodes);
+            unite(nodes);
+        }
+        for (auto &h : heuristic_) {
+            nodes.clear();
+            nodes.emplace_back(node(h.a));
+            collectLits(h.body, nodes);
+            unite(nodes);
+        }
+        for (auto &e : external_) { node(e.a); }
+        // Note: acyclicity couples all edges
+        nodes.clear();
+        for (auto &a : acyc_) { collectLits(a.body, nodes); }
+        unite(nodes);
+        for (auto &m : minimize_) {
+            for (auto &l : m.body) { node(atom(l.lit)); }
+        }
+        for (auto &a : assume_) {
+            for (auto &l : a.body) { node(atom(l)); }
+        }
+        for (auto &p : project_) {
+            for (auto &a : p.body) { node(a); }
+        }
+        for (auto it = data_.currBegin(), ie = data_.end(); it != ie; ++it) {
+            auto &&atom = **it;
+            if (distributive(atom)) {
+                for (auto &&elemId : atom) {
+                    nodes.clear();
+                    collectElement(elemId, nodes);
+                    unite(nodes);
+                }
+            }
+            else {
+                nodes.clear();
+                collectAtom(atom, nodes);
+                unite(nodes);
+            }
+        }
+    }
+    void number() {
+        // Note: components with a single node are merged into the first component
+        std::vector<unsigned> size(parent_.size(), 0);
+        for (unsigned n = 0; n < parent_.size(); ++n) { ++size[find(n)]; }
+        component_.assign(parent_.size(), 0);
+        nontrivial_ = 0;
+        for (unsigned n = 0; n < parent_.size(); ++n) {
+            if (find(n) == n && size[n] > 1) { component_[n] = nontrivial_++; }
+        }
+    }
+    unsigned component(std::vector<unsigned> const &nodes) {
+        return nodes.empty() ? 0 : component_[find(nodes.front())];
+    }
+    unsigned component(Atom_t a) {
+        return component_[find(node(a))];
+    }
+
+    // {{{2 writing the components
+
+    void copyTerm(TheoryData &data, Id_t termId) {
+        if (data.hasTerm(termId)) { return; }
+        auto &&term = data_.getTerm(termId);
+        switch (term.type()) {
+            case Theory_t::Number: { data.addTerm(termId, term.number()); break; }
+            case Theory_t::Symbol: { data.addTerm(termId, term.symbol()); break; }
+            case Theory_t::Compound: {
+                for (auto &&t : term) { copyTerm(data, t); }
+                if (term.isFunction()) {
+                    copyTerm(data, term.function());
+                    data.addTerm(termId, term.function(), term.terms());
+                }
+                else {
+                    data.addTerm(termId, term.tuple(), term.terms());
+                }
+                break;
+            }
+        }
+    }
+    void copyAtom(TheoryData &data, TheoryAtom const &atom, std::vector<Id_t> const &elems) {
+        for (auto &&elemId : elems) {
+            if (data.hasElement(elemId)) { continue; }
+            auto &&elem = data_.getElement(elemId);
+            for (auto &&t : elem) { copyTerm(data, t); }
+            data.addElement(elemId, elem.terms(), elem.condition());
+        }
+        copyTerm(data, atom.term());
+        if (atom.guard()) {
+            copyTerm(data, *atom.guard());
+            copyTerm(data, *atom.rhs());
+            data.addAtom(atom.atom(), atom.occurrence(), atom.term(), toSpan(elems), *atom.guard(), *atom.rhs());
+        }
+        else {
+            data.addAtom(atom.atom(), atom.occurrence(), atom.term(), toSpan(elems));
+        }
+    }
+    template <class T, class F>
+    std::map<unsigned, std::vector<T>> distribute(std::vector<T> const &xs, F f) {
+        std::map<unsigned, std::vector<T>> parts;
+        for (auto &x : xs) { parts[f(x)].emplace_back(x); }
+        return parts;
+    }
+    AspifCOutput &out(unsigned c) {
+        return components_[c]->out;
+    }
+    void write() {
+        std::vector<unsigned> nodes;
+        for (auto &r : rules_) {
+            unsigned c = !r.head.empty() ? component(r.head.front()) : !r.body.empty() ? component(atom(r.body.front().lit)) : 0;
+            out(c).rule({r.headType, toSpan(r.head)}, {r.bodyType, r.bound, toSpan(r.body)});
+        }
+        for (auto &m : minimize_) {
+            auto parts = distribute(m.body, [this](WeightLit_t const &l) { return component(atom(l.lit)); });
+            if (parts.empty()) { out(0).minimize(m.prio, toSpan(m.body)); }
+            for (auto &p : parts) { out(p.first).minimize(m.prio, toSpan(p.second)); }
+        }
+        for (auto &o : output_) {
+            unsigned c = !o.body.empty() ? component(atom(o.body.front())) : 0;
+            out(c).output(toSpan(o.str.c_str(), o.str.size()), toSpan(o.body));
+        }
+        for (auto &a : assume_) {
+            for (auto &p : distribute(a.body, [this](Lit_t l) { return component(atom(l)); })) {
+                out(p.first).assume(toSpan(p.second));
+            }
+        }
+        for (auto &e : external_) { out(component(e.a)).external(e.a, e.v); }
+        if (!project_.empty()) {
+            // Note: every component has to be projected if the program is
+            std::vector<bool> projected(components_.size(), false);
+            for (auto &a : project_) {
+                for (auto &p : distribute(a.body, [this](Atom_t x) { return component(x); })) {
+                    out(p.first).project(toSpan(p.second));
+                    projected[p.first] = true;
+                }
+            }
+            for (unsigned c = 0; c < components_.size(); ++c) {
+                if (!projected[c]) { out(c).project(toSpan<Atom_t>()); }
+            }
+        }
+        unsigned acyc = 0;
+        for (auto &a : acyc_) {
+            if (!a.body.empty()) {
+                acyc = component(atom(a.body.front()));
+                break;
+            }
+        }
+        for (auto &a : acyc_) { out(acyc).acycEdge(a.s, a.t, toSpan(a.body)); }
+        for (auto &h : heuristic_) { out(component(h.a)).heuristic(h.a, h.t, h.bias, h.prio, toSpan(h.body)); }
+        for (auto it = data_.currBegin(), ie = data_.end(); it != ie; ++it) {
+            auto &&atom = **it;
+            if (distributive(atom)) {
+                std::vector<std::vector<Id_t>> parts(components_.size());
+                for (auto &&elemId : atom) {
+                    nodes.clear();
+                    collectElement(elemId, nodes);
+                    parts[component(nodes)].emplace_back(elemId);
+                }
+                // Note: an empty show directive still hides all variables of a component
+                bool show = std::strcmp(data_.getTerm(atom.term()).symbol(), "show") == 0;
+                for (unsigned c = 0; c < components_.size(); ++c) {
+                    if (show || !parts[c].empty()) { copyAtom(components_[c]->data, atom, parts[c]); }
+                }
+            }
+            else {
+                nodes.clear();
+                collectAtom(atom, nodes);
+                std::vector<Id_t> elems(atom.begin(), atom.end());
+                copyAtom(components_[component(nodes)]->data, atom, elems);
+            }
+        }
+    }
+
+    // }}}2
+
+    TheoryData &data_;
+    ConditionVec &conditions_;
+    std::vector<Rule> rules_;
+    std::vector<Output> output_;
+    std::vector<Minimize> minimize_;
+    std::vector<Assume> assume_;
+    std::vector<External> external_;
+    std::vector<Heuristic> heuristic_;
+    std::vector<Acyc> acyc_;
+    std::vector<Project> project_;
+    std::vector<unsigned> parent_;
+    std::vector<unsigned> atomNodes_;
+    std::unordered_map<Id_t, unsigned> varNodes_;
+    std::vector<unsigned> component_;
+    unsigned nontrivial_ = 0;
+    std::vector<std::unique_ptr<Component>> components_;
+};
+
+Splitter::Splitter(ConditionVec &conditions, TheoryData &data)
+: impl_(new Splitter::Impl(conditions, data)) { }
+
+unsigned Splitter::components() const {
+    return impl_->components();
+}
+
+std::string const &Splitter::program(unsigned component) const {
+    return impl_->program(component);
+}
+
+void Splitter::initProgram(bool incremental) {
+    if (incremental) { throw std::runtime_error("splitting is not supported for incremental programs"); }
+}
+
+void Splitter::beginStep() {
+}
+
+void Splitter::rule(const HeadView& head, const BodyView& body) {
+    impl_->add(Rule{
+        {head.atoms.first, head.atoms.first + head.atoms.size},
+        {body.lits.first, body.lits.first + body.lits.size},
+        head.type, body.type,
+        body.bound});
+}
+
+void Splitter::minimize(Weight_t prio, const WeightLitSpan& lits) {
+    impl_->add(Minimize{
+        prio,
+        {lits.first, lits.first + lits.size}});
+}
+
+void Splitter::output(const StringSpan& str, const LitSpan& lits) {
+    impl_->add(Output{
+        {str.first, str.first + str.size},
+        {lits.first, lits.first + lits.size}});
+}
+
+void Splitter::assume(const LitSpan& lits) {
+    impl_->add(Assume{{lits.first, lits.first + lits.size}});
+}
+
+void Splitter::external(Atom_t a, Value_t v) {
+    impl_->add(External{a, v});
+}
+
+void Splitter::project(const AtomSpan& atoms) {
+    impl_->add(Project{{atoms.first, atoms.first + atoms.size}});
+}
+
+void Splitter::acycEdge(int s, int t, const LitSpan& body) {
+    impl_->add(Acyc{s, t, {body.first, body.first + body.size}});
+}
+
+void Splitter::heuristic(Atom_t a, Heuristic_t t, int bias, unsigned prio, const LitSpan& body) {
+    impl_->add(Heuristic{a, t, bias, prio, {body.first, body.first + body.size}});
+}
+
+void Splitter::endStep() {
+    impl_->split();
+}
+
+Splitter::~Splitter() noexcept = default;
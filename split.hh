@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2015, Anonymous Author (temporary)
+//
+// This file is part of lc2casp. See https://github.com/lc2casp/lc2casp
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+#ifndef LIBFOUNDED_SPLIT_H_INCLUDED
+#define LIBFOUNDED_SPLIT_H_INCLUDED
+#include <potassco/basic_types.h>
+#include <potassco/theory_data.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using ConditionVec = std::vector<std::vector<Potassco::Lit_t>>;
+
+// Splits a translated program into independent components, i.e., programs
+// that share neither atoms nor constraint variables. The answer sets of the
+// program are the combinations of one answer set of each component.
+//
+// Minimize statements, assumptions, projections, and the elements of &show
+// and &minimize directives are distributed over the components. Atoms and
+// variables not connected to anything else are kept with the first component.
+class Splitter : public Potassco::LpElement {
+public:
+    class Impl;
+    Splitter(ConditionVec &conditions, Potassco::TheoryData &data);
+    Splitter(const Splitter&) = delete;
+    Splitter& operator=(const Splitter&) = delete;
+    // The number of components; available after the end of the step.
+    unsigned components() const;
+    // The given component in aspif format; available after the end of the step.
+    std::string const &program(unsigned component) const;
+    virtual void initProgram(bool);
+    virtual void beginStep();
+    virtual void rule(const Potassco::HeadView& head, const Potassco::BodyView& body);
+    virtual void minimize(Potassco::Weight_t prio, const Potassco::WeightLitSpan& lits);
+    virtual void output(const Potassco::StringSpan& str, const Potassco::LitSpan& cond);
+    virtual void assume(const Potassco::LitSpan& lits);
+    virtual void external(Potassco::Atom_t a, Potassco::Value_t v);
+    virtual void project(const Potassco::AtomSpan& atoms);
+    virtual void acycEdge(int s, int t, const Potassco::LitSpan& condition);
+    virtual void heuristic(Potassco::Atom_t a, Potassco::Heuristic_t t, int bias, unsigned prio, const Potassco::LitSpan& condition);
+    virtual void endStep();
+    virtual ~Splitter() noexcept;
+private:
+    std::unique_ptr<Impl> impl_;
+};
+
+#endif
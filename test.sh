@@ -57,6 +57,11 @@ Usage:
 The first invocation prints this help, the second runs all tests, and the third
 takes a logic program, runs grounder, translator, and solver, and normalizes
 its output.
+
+Besides logic programs, the tests translate the aspif programs in test and
+compare the result byte by byte with the accompanying .out files. If a
+directory named like the program exists, the program is also split and each
+component is compared with the matching component-<i>.out file in it.
 EOF
 }
 
@@ -134,6 +139,62 @@ else
             #TODO: record failure and report at the end
         fi
     done
+    # translations of aspif programs are compared byte by byte
+    for x in $wd/test/**/*.aspif(N); do
+        run=$[run+1]
+        name=${x%.aspif}
+        if $founded "$x" | cmp -s - "$name.out"; then
+            print -n "."
+        else
+            print -n "F"
+            fail=$[fail+1]
+            failures+=($x)
+        fi
+    done
+    # splitting writes one program per component, which are compared byte by
+    # byte with the files in the directory named after the aspif program
+    for x in $wd/test/**/*.aspif(N); do
+        name=${x%.aspif}
+        [[ -d "$name" ]] || continue
+        run=$[run+1]
+        split=$(mktemp -d)
+        expected=($name/component-*.out(N))
+        ok=0
+        if $founded --split="$split" "$x" 2> /dev/null && [[ $(wc -l < "$split/manifest") -eq ${#expected} ]]; then
+            ok=1
+            for out in "${expected[@]}"; do
+                cmp -s "$split/${out:t:r}.aspif" "$out" || ok=0
+            done
+        fi
+        if [[ ok -eq 1 ]]; then
+            print -n "."
+        else
+            print -n "F"
+            fail=$[fail+1]
+            failures+=("$x (split)")
+        fi
+        rm -rf "$split"
+    done
+    # the cache stores the translation on a miss, serves the stored entry on a hit,
+    # and never evicts files it did not write
+    for x in $wd/test/**/*.aspif(N); do
+        run=$[run+1]
+        name=${x%.aspif}
+        cache=$(mktemp -d)
+        print "not an entry" > "$cache/notes.txt"
+        if $founded --cache="$cache" --cache-size=0 "$x" | cmp -s - "$name.out" &&
+           entries=($cache/*.aspif(N)) && [[ ${#entries} -eq 1 ]] && cmp -s "$entries[1]" "$name.out" &&
+           print "cached" > "$entries[1]" &&
+           $founded --cache="$cache" --cache-size=0 "$x" | cmp -s - <(print "cached") &&
+           [[ -e "$cache/notes.txt" ]]; then
+            print -n "."
+        else
+            print -n "F"
+            fail=$[fail+1]
+            failures+=("$x (cache)")
+        fi
+        rm -rf "$cache"
+    done
     print
     print
     print -n "OK ($[run-fail]/${run})"
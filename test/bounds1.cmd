@@ -0,0 +1,2 @@
+
+--bounds-file=test/bounds1.bnd
@@ -0,0 +1,3 @@
+Step: 1
+x=2 y=2 z(1)=2
+SAT
@@ -0,0 +1,8 @@
+Step: 1
+p(1) p(2) x(1)=1 x(2)=2
+p(1) p(2) x(1)=2 x(2)=1
+p(1) p(3) x(1)=1 x(3)=2
+p(1) p(3) x(1)=2 x(3)=1
+p(2) p(3) x(2)=1 x(3)=2
+p(2) p(3) x(2)=2 x(3)=1
+SAT
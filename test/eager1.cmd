@@ -0,0 +1,2 @@
+
+--eager=100
@@ -0,0 +1,14 @@
+Step: 1
+a=1 b=2 c=3 d=1 p(a) p(b) p(c)
+a=1 b=2 c=3 d=2 p(a) p(b) p(c)
+a=1 b=3 c=2 d=1 p(a) p(b) p(c)
+a=1 b=3 c=2 d=2 p(a) p(b) p(c)
+a=2 b=1 c=3 d=1 p(a) p(b) p(c)
+a=2 b=1 c=3 d=2 p(a) p(b) p(c)
+a=2 b=3 c=1 d=1 p(a) p(b) p(c)
+a=2 b=3 c=1 d=2 p(a) p(b) p(c)
+a=3 b=1 c=2 d=1 p(a) p(b) p(c)
+a=3 b=1 c=2 d=2 p(a) p(b) p(c)
+a=3 b=2 c=1 d=1 p(a) p(b) p(c)
+a=3 b=2 c=1 d=2 p(a) p(b) p(c)
+SAT
@@ -0,0 +1,2 @@
+--heuristic=domain
+--heuristic=level
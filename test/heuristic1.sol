@@ -0,0 +1,8 @@
+Step: 1
+a x=1 y=1
+a x=1 y=2
+a x=1 y=3
+x=1
+x=4
+x=5
+SAT
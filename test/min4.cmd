@@ -0,0 +1,2 @@
+-q1,1 --opt-mode=optN
+--bound-objective
@@ -0,0 +1,3 @@
+Step: 1
+a b x=1 y=5
+OPTIMUM FOUND
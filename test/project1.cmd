@@ -0,0 +1,2 @@
+--project
+--project --bounds=0,3
@@ -0,0 +1,8 @@
+Step: 1
+a x=1 z=1
+a x=1 z=2
+a x=2 z=2
+x=1 z=1
+x=1 z=2
+x=2 z=2
+SAT
@@ -0,0 +1,2 @@
+
+--break-symmetries
@@ -0,0 +1,5 @@
+Step: 1
+p(1) p(2) p(3) x(1)=1 x(2)=2 x(3)=3 y=1 z=2
+p(1) p(2) p(3) x(1)=1 x(2)=2 x(3)=3 y=2 z=1
+p(1) p(2) p(3) x(1)=1 x(2)=2 x(3)=3 y=2 z=2
+SAT
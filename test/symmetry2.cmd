@@ -0,0 +1,2 @@
+
+--break-symmetries --bounds-file=test/symmetry2.bnd
@@ -0,0 +1,5 @@
+Step: 1
+x=3 y=1
+x=3 y=2
+x=3 y=3
+SAT
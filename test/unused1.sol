@@ -0,0 +1,6 @@
+Step: 1
+a x=1
+a x=1
+x=1
+x=1
+SAT
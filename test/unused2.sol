@@ -0,0 +1,6 @@
+Step: 1
+x=1
+x=1
+x=2
+x=2
+SAT
@@ -0,0 +1,2 @@
+--heuristic=domain
+--warm-start=test/warm1.ws
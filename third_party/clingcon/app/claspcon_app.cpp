@@ -68,9 +68,17 @@ public:
             constraints = n_.constraints();
         }
         
+        /// with several solvers every propagator needs its own copy of the constraints,
+        /// solvers may be attached concurrently and in any order
+        std::vector<order::ReifiedLinearConstraint> own;
+        if (s.sharedContext()->concurrency() > 1)
+            own = n_.constraints();
+        else
+            own = std::move(n_.constraints());
+
         ///solver takes ownership of propagator
         clingcon::ClingconOrderPropagator* cp = new clingcon::ClingconOrderPropagator(s, n_.getVariableCreator(), conf_,
-                                                                                      std::move(n_.constraints()),n_.getEqualities(),
+                                                                                      std::move(own),n_.getEqualities(),
                                                                                       &(to_.names_));
         to_.props_[s.id()]=cp;
         if (!s.addPost(cp))
@@ -124,6 +132,7 @@ void ClaspConApp::initOptions(ProgramOptions::OptionContext& root)
             ("translate-constraints", storeTo(conf_.translateConstraints = 1000), "translate constraints with an estimated number of clauses less than this (default: 1000)")
             ("min-lits-per-var", storeTo(conf_.minLitsPerVar = 1000), "minimum number of precreated literals per variable (-1=all) (default: 1000)")
             ("equalityProcessing", storeTo(conf_.equalityProcessing = true), "find and replace equal variable views (default: true)")
+            ("translate-threads", storeTo(conf_.translateThreads = 1), "number of threads used to translate constraints into clauses (default: 1)")
             ;
     root.add(cspconf);
     
@@ -159,7 +168,7 @@ void ClaspConApp::run(Clasp::ClaspFacade& clasp) {
     auto& td = lp->theoryData();
     MySharedContext s(clasp.ctx);
     order::Normalizer n(s,conf_);
-    clingcon::TheoryParser tp(n,td,lp,s.trueLit());
+    clingcon::TheoryParser tp(n,s,td,lp);
     TheoryOutput to; /// only valid for this method, but i do have pointer to it in Configurator, is this ok ?
     Configurator conf(conf_,n,to);
     claspConfig_.addConfigurator(&conf);
@@ -73,6 +73,8 @@ private:
     /// all these things should be on the watch stack in the same order
     /// but may be interleaved with some others
     std::vector<difflogic::DLPropagator::EdgeId> pending_; /// a list of EdgeId's that are pending to be propagated by us
+    std::vector<difflogic::DLPropagator::EdgeId> consequences_; /// reused buffer for p_.activate/deactivate
+    std::vector<difflogic::DLPropagator::EdgeId> reason_; /// reused buffer for p_.reason
     
     std::vector<unsigned int> activationsPerDl_; /// the number of activations per decision level
     std::vector<unsigned int> dls_; 
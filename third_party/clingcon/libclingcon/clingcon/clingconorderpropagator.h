@@ -165,14 +165,14 @@ private:
     /// For each CSP Variable there is an int x
     /// abs(x)-1: steps from the lowest element of the variable to the actual value that is referenced
     /// sign(x): positive if literal without sign means v <= y, negative if literal with sign means v <= y
-    std::unordered_map<Clasp::Var, std::vector<std::pair<order::Variable, int32> > > propVar2cspVar_;/// Clasp Literals to csp variables+bound
+    std::vector<std::vector<std::pair<order::Variable, int32> > > propVar2cspVar_;/// Clasp Literals to csp variables+bound, indexed by Clasp::Var
     //const std::vector<std::unique_ptr<order::LitVec> >& var2OrderLits_; /// CSP variables to Clasp::order
 
     std::vector<std::size_t> dls_; /// every decision level that we are registered for
 
     bool assertConflict_;
 
-    std::unordered_map<Clasp::Var, Clasp::LitVec> reasons_; /// for every variable i store a reason if i have to give it,
+    std::vector<Clasp::LitVec> reasons_; /// for every variable i store a reason if i have to give it, indexed by Clasp::Var
                                                             /// can contain reasons that are no longer valid (does not shrink)
     Clasp::LitVec conflict_;                               /// only set in imediate conflict in addition to reasons,
                                                             /// as reason can already be set for this variable (opposite sign)
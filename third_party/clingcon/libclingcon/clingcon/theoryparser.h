@@ -19,10 +19,20 @@ class TheoryParser
 public:
     enum CType {SUM, DOM, DISTINCT, SHOW, MINIMIZE};
     using mytuple = std::vector<Potassco::Id_t>;   /// a tuple identifier
-    using tuple2View = std::map<mytuple, order::View>; // could be unordered
-
-    TheoryParser(order::Normalizer& n, Potassco::TheoryData& td, Clasp::Asp::LogicProgram* lp, order::Literal trueLit) :
-        n_(n), td_(td), lp_(lp), trueLit_(trueLit)
+    struct TupleHash
+    {
+        std::size_t operator()(const mytuple& t) const
+        {
+            std::size_t seed = t.size();
+            for (auto i : t)
+                seed ^= std::hash<Potassco::Id_t>()(i) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
+    using tuple2View = std::unordered_map<mytuple, order::View, TupleHash>;
+
+    TheoryParser(order::Normalizer& n, order::CreatingSolver& s, Potassco::TheoryData& td, Clasp::Asp::LogicProgram* lp) :
+        n_(n), s_(s), td_(td), lp_(lp), trueLit_(s.trueLit())
     {}
 
     /// returns false, if not a constraint of this theory
@@ -50,6 +60,12 @@ private:
 
     std::stringstream& toString(std::stringstream& ss, const Potassco::TheoryData::Term& t);
 
+    /// true if id is the symbol s, compares in place without building a string
+    bool isSymbol(Potassco::Id_t id, const char* s);
+
+    /// true if id does not name a function, i.e. is an arithmetic or other operator
+    bool isOperator(Potassco::Id_t id);
+
     bool isNumber(Potassco::Id_t id);
 
     int getNumber(Potassco::Id_t id);
@@ -75,6 +91,15 @@ private:
 
     order::View createVar(Potassco::Id_t id, int32 val);
 
+    /// literal of the condition of a theory element, trueLit_ if there is none
+    order::Literal getCondition(const Potassco::TheoryData::Element& elem);
+
+    /// returns a new view that is equal to v if cond holds and 0 otherwise
+    order::View conditionalView(order::View v, order::Literal cond);
+
+    /// returns a new view that is equal to val if cond holds and 0 otherwise
+    order::View conditionalView(int32 val, order::Literal cond);
+
     
 private:
     
@@ -87,9 +112,12 @@ private:
     std::vector<std::pair<Potassco::Id_t,Clasp::Literal>> shown_; /// order::Variable to TermId + condition literal
     std::vector<std::pair<Potassco::Id_t,Clasp::Literal>> shownPred_; /// a list of p/3 predicates to be shown + condition literal
     std::vector<tuple2View> minimize_;                /// for each level
+    std::unordered_map<order::Variable, order::Domain> domains_; /// domains of variables given as facts
+    std::vector<std::pair<order::View,order::View>> conditional_; /// views of conditional elements and their conditioned view
     
     std::vector<order::View>  termId2View_;
     order::Normalizer& n_;
+    order::CreatingSolver& s_;
     Potassco::TheoryData& td_;
     Clasp::Asp::LogicProgram* lp_;
     order::Literal trueLit_;
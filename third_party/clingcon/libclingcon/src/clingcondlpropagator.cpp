@@ -69,8 +69,8 @@ void ClingconDLPropagator::reason(Clasp::Solver& s, Clasp::Literal p, Clasp::Lit
     if (lid.sign())
         id *=-1;
     //std::cout << "Need reason for " << p.var() << "," << p.sign() << " which has data " << id << " at level " << s_.level(p.var()) << std::endl;
-    auto reason = p_.reason(id);
-    for (auto i : reason)
+    p_.reason(id, reason_);
+    for (auto i : reason_)
         lits.push_back(edgeid2lit(i));
 //    std::cout << "Reason: ";
 //    for (auto i : reason)
@@ -100,14 +100,14 @@ bool ClingconDLPropagator::init(Clasp::Solver& s)
     }
     for (unsigned int i = 0; i != literals_.size(); ++i)
     {
-        std::vector<difflogic::DLPropagator::EdgeId> consequences;
+        consequences_.clear();
         if (s.isFalse(literals_[i]))
-            consequences = p_.deactivate(i+1);
+            p_.deactivate(i+1, consequences_);
         else
         if (s.isTrue(literals_[i]))
-            consequences = p_.activate(i+1);
+            p_.activate(i+1, consequences_);
             
-        for (const auto& j : consequences)
+        for (const auto& j : consequences_)
         {
             Clasp::Literal l = edgeid2lit(j);
             if (!s_.isTrue(l))
@@ -150,8 +150,8 @@ bool ClingconDLPropagator::propagateFixpoint(Clasp::Solver& , PostPropagator*)
              {
                  //std::cout << "propagate " << l.var() << "," << l.sign() << " @" << s_.level(l.var()) << std::endl;
                  ++(activationsPerDl_.back());
-                 auto conseq = p_.activate(i);
-                 for (const auto& j : conseq)
+                 p_.activate(i, consequences_);
+                 for (const auto& j : consequences_)
                  {
                      Clasp::Literal l = edgeid2lit(j);
                      if (!s_.isTrue(l))
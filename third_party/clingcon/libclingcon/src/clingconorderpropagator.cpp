@@ -25,8 +25,8 @@ Clasp::Constraint::PropResult ClingconOrderPropagator::propagate(Clasp::Solver&
     if (blob.sign())
     {
         ///order literal
-        assert(propVar2cspVar_.find(p.var())!=propVar2cspVar_.end());
-        auto cspVars = propVar2cspVar_[p.var()];
+        assert(p.var() < propVar2cspVar_.size() && !propVar2cspVar_[p.var()].empty());
+        const auto& cspVars = propVar2cspVar_[p.var()];
 
 
         for (auto cspVar : cspVars)
@@ -116,7 +116,10 @@ void ClingconOrderPropagator::reason(Clasp::Solver& s, Clasp::Literal p, Clasp::
         conflict_.clear();
     }
     else
+    {
+        assert(p.var() < reasons_.size());
         lits.insert(lits.end(),reasons_[p.var()].begin(), reasons_[p.var()].end());
+    }
 }
 
 
@@ -186,10 +189,13 @@ bool ClingconOrderPropagator::propagateFixpoint(Clasp::Solver& , PostPropagator*
                     }
                     else
                     {
-                        reasons_[claspClause.begin()->var()].clear();
+                        Clasp::Var v = claspClause.begin()->var();
+                        if (reasons_.size() <= v)
+                            reasons_.resize(v+1);
+                        reasons_[v].clear();
                         conflict_.clear();
                         for (auto i = claspClause.begin()+1; i != claspClause.end(); ++i)
-                            reasons_[claspClause.begin()->var()].push_back(~(*i));
+                            reasons_[v].push_back(~(*i));
                     }
                     if (!s_.force(*claspClause.begin(),this))
                         return false;
@@ -209,6 +215,8 @@ void ClingconOrderPropagator::addWatch(const order::Variable& var, const Clasp::
     s_.addWatch(cl, this, blob.rep());
     s_.addWatch(~cl, this, blob.rep());
     int32 x = cl.sign() ? int32(step+1)*-1 : int32(step+1);
+    if (propVar2cspVar_.size() <= cl.var())
+        propVar2cspVar_.resize(cl.var()+1);
     propVar2cspVar_[cl.var()].emplace_back(std::make_pair(var,x));
 }
 
@@ -1,5 +1,7 @@
 #include "theoryparser.h"
 #include "clasp/logic_program.h"
+#include <cctype>
+#include <cstring>
 
 
 
@@ -12,21 +14,19 @@ using namespace order;
     {
         if (termId2constraint_.find(id) == termId2constraint_.end())
         {
-            std::string s = toString(td_.getTerm(id));
-
-            if (s=="sum")
+            if (isSymbol(id,"sum"))
                 termId2constraint_[id]=SUM;
             else
-                if (s=="dom")
+                if (isSymbol(id,"dom"))
                     termId2constraint_[id]=DOM;
                 else
-                    if (s=="show")
+                    if (isSymbol(id,"show"))
                         termId2constraint_[id]=SHOW;
                     else
-                        if (s=="distinct")
+                        if (isSymbol(id,"distinct"))
                             termId2constraint_[id]=DISTINCT;
                         else
-                            if (s=="minimize")
+                            if (isSymbol(id,"minimize"))
                                 termId2constraint_[id]=MINIMIZE;
                             else // last
                                 return false;
@@ -39,24 +39,22 @@ using namespace order;
     {
         if (termId2guard_.find(id) == termId2guard_.end())
         {
-            std::string s = toString(td_.getTerm(id));
-
-            if (s=="=")
+            if (isSymbol(id,"="))
                 termId2guard_[id]=order::LinearConstraint::Relation::EQ;
             else
-                if (s=="<=")
+                if (isSymbol(id,"<="))
                     termId2guard_[id]=order::LinearConstraint::Relation::LE;
                 else
-                    if (s==">=")
+                    if (isSymbol(id,">="))
                         termId2guard_[id]=order::LinearConstraint::Relation::GE;
                     else
-                        if (s=="<")
+                        if (isSymbol(id,"<"))
                             termId2guard_[id]=order::LinearConstraint::Relation::LT;
                         else
-                            if (s==">")
+                            if (isSymbol(id,">"))
                                 termId2guard_[id]=order::LinearConstraint::Relation::GT;
                             else
-                                if (s=="!=")
+                                if (isSymbol(id,"!="))
                                     termId2guard_[id]=order::LinearConstraint::Relation::NE;
             else // last
                 return false;
@@ -66,6 +64,18 @@ using namespace order;
     }
 
 
+    bool TheoryParser::isSymbol(Potassco::Id_t id, const char* s)
+    {
+        auto& t = td_.getTerm(id);
+        return t.type()==Potassco::Theory_t::Symbol && std::strcmp(t.symbol(),s)==0;
+    }
+
+    bool TheoryParser::isOperator(Potassco::Id_t id)
+    {
+        auto& t = td_.getTerm(id);
+        return t.type()!=Potassco::Theory_t::Symbol || !std::isalpha(static_cast<unsigned char>(*t.symbol()));
+    }
+
     std::stringstream& TheoryParser::toString(std::stringstream& ss, const Potassco::TheoryData::Term& t)
     {
         if (t.type()==Potassco::Theory_t::Number)
@@ -118,27 +128,27 @@ using namespace order;
         {
             if (a.isFunction())
             {
-                if (toString(td_.getTerm(a.function()))=="+" && a.size()==1)
+                if (isSymbol(a.function(),"+") && a.size()==1)
                 {
                     //unary plus
                     return isNumber(*a.begin());
                 }
-                if (toString(td_.getTerm(a.function()))=="-" && a.size()==1)
+                if (isSymbol(a.function(),"-") && a.size()==1)
                 {
                     //unary minus
                     return isNumber(*a.begin());
                 }
-                if (toString(td_.getTerm(a.function()))=="+" && a.size()==2)
+                if (isSymbol(a.function(),"+") && a.size()==2)
                 {
                     //binary plus
                     return isNumber(*a.begin()) && isNumber(*(a.begin()+1));
                 }
-                if (toString(td_.getTerm(a.function()))=="-" && a.size()==2)
+                if (isSymbol(a.function(),"-") && a.size()==2)
                 {
                     //binary minus
                     return isNumber(*a.begin()) && isNumber(*(a.begin()+1));
                 }
-                if (toString(td_.getTerm(a.function()))=="*" && a.size()==2)
+                if (isSymbol(a.function(),"*") && a.size()==2)
                 {
                     //binary times
                     return isNumber(*a.begin()) && isNumber(*(a.begin()+1));
@@ -159,27 +169,27 @@ using namespace order;
         {
             if (a.isFunction())
             {
-                if (toString(td_.getTerm(a.function()))=="+" && a.size()==1)
+                if (isSymbol(a.function(),"+") && a.size()==1)
                 {
                     //unary plus
                     return getNumber(*a.begin());
                 }
-                if (toString(td_.getTerm(a.function()))=="-" && a.size()==1)
+                if (isSymbol(a.function(),"-") && a.size()==1)
                 {
                     //unary minus
                     return -getNumber(*a.begin());
                 }
-                if (toString(td_.getTerm(a.function()))=="+" && a.size()==2)
+                if (isSymbol(a.function(),"+") && a.size()==2)
                 {
                     //binary plus
                     return getNumber(*a.begin()) + getNumber(*(a.begin()+1));
                 }
-                if (toString(td_.getTerm(a.function()))=="-" && a.size()==2)
+                if (isSymbol(a.function(),"-") && a.size()==2)
                 {
                     //binary minus
                     return getNumber(*a.begin()) - getNumber(*(a.begin()+1));
                 }
-                if (toString(td_.getTerm(a.function()))=="*" && a.size()==2)
+                if (isSymbol(a.function(),"*") && a.size()==2)
                 {
                     //binary times
                     return getNumber(*a.begin()) * getNumber(*(a.begin()+1));
@@ -226,20 +236,19 @@ using namespace order;
         {
             if (a.isFunction())
             {
-                std::string fname(toString(td_.getTerm(a.function())));
-                if (!isalpha(fname[0]))
+                if (isOperator(a.function()))
                 {
-                    if (toString(td_.getTerm(a.function()))=="+" && a.size()==1)
+                    if (isSymbol(a.function(),"+") && a.size()==1)
                     {
                         return getView(*a.begin(),v);
                     }
-                    if (toString(td_.getTerm(a.function()))=="-" && a.size()==1)
+                    if (isSymbol(a.function(),"-") && a.size()==1)
                     {
                         bool b = getView(*a.begin(),v);
                         v = v*-1;
                         return b;
                     }
-                    if (toString(td_.getTerm(a.function()))=="+" && a.size()==2)
+                    if (isSymbol(a.function(),"+") && a.size()==2)
                     {
                         //binary plus
                         if (isNumber(*a.begin()) && isNumber(*(a.begin()+1)))
@@ -265,7 +274,7 @@ using namespace order;
                                     return false;
                         }
                     }
-                    if (toString(td_.getTerm(a.function()))=="-" && a.size()==2)
+                    if (isSymbol(a.function(),"-") && a.size()==2)
                     {
                         //binary minus
                         if (isNumber(*a.begin()) && isNumber(*(a.begin()+1)))
@@ -294,7 +303,7 @@ using namespace order;
                         }
 
                     }
-                    if (toString(td_.getTerm(a.function()))=="*" && a.size()==2)
+                    if (isSymbol(a.function(),"*") && a.size()==2)
                     {
                         //binary times
                         if (isNumber(*a.begin()) && isNumber(*(a.begin()+1)))
@@ -361,6 +370,41 @@ using namespace order;
         return v;
     }
 
+    order::Literal TheoryParser::getCondition(const Potassco::TheoryData::Element& elem)
+    {
+        if (elem.condition()==0)
+            return trueLit_;
+        return toOrderFormat(lp_->getLiteral(elem.condition()));
+    }
+
+    order::View TheoryParser::conditionalView(order::View v, order::Literal cond)
+    {
+        /// cond -> y=v, not cond -> y=0
+        order::View y = n_.createView();
+        conditional_.emplace_back(y,v);
+        order::Literal eq = s_.getNewLiteral(false);
+        order::Literal zero = s_.getNewLiteral(false);
+        LinearConstraint lc(LinearConstraint::Relation::EQ);
+        lc.add(y);
+        lc.add(v*-1);
+        n_.addConstraint(ReifiedLinearConstraint(std::move(lc),eq));
+        n_.addConstraint(ReifiedDomainConstraint(y,order::Domain(0),zero));
+        s_.createClause(order::LitVec{~cond,eq});
+        s_.createClause(order::LitVec{cond,zero});
+        return y;
+    }
+
+    order::View TheoryParser::conditionalView(int32 val, order::Literal cond)
+    {
+        /// y in {0,val}, y=val <-> cond
+        order::View y = n_.createView(order::Domain(std::min(val,0),std::max(val,0)));
+        order::Domain d(0);
+        d.unify(val,val);
+        n_.addConstraint(ReifiedDomainConstraint(y,std::move(d),trueLit_));
+        n_.addConstraint(ReifiedDomainConstraint(y,order::Domain(val),cond));
+        return y;
+    }
+
     bool TheoryParser::check(Potassco::Id_t id)
     {
         auto& a = td_.getTerm(id);
@@ -378,8 +422,7 @@ using namespace order;
         {
             if (a.isFunction())
             {
-                std::string fname(toString(td_.getTerm(a.function())));
-                if (!isalpha(fname[0]))
+                if (isOperator(a.function()))
                     return false;
                 for (auto i = a.begin(); i != a.end();++i)
                     if (!check(*i))
@@ -419,10 +462,10 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
         for (auto elemId = (*i)->begin(); elemId != (*i)->end(); ++elemId)
         {
             auto& elem = td_.getElement(*elemId);
-            if (elem.condition()!=0)
-                error("Conditions on theory terms not yet supported");
-            // check condition of element
-            //elem->condition;
+            // elements with a false condition do not contribute to the sum
+            order::Literal cond = getCondition(elem);
+            if (s_.isFalse(cond))
+                continue;
             assert(elem.size()>=1);
             /// everything more than 1 element is just for set semantics and is not used in the theory
             //for (auto single_elem = elem.begin(); single_elem != elem.end(); ++single_elem)
@@ -433,13 +476,16 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
 //                std::cout << std::endl;
                 if (isNumber(*single_elem))
                 {
-                    lc.addRhs(-getNumber(*single_elem));
+                    if (s_.isTrue(cond))
+                        lc.addRhs(-getNumber(*single_elem));
+                    else if (getNumber(*single_elem)!=0)
+                        lc.add(conditionalView(getNumber(*single_elem),cond));
                 }
                 else
                 {
                     order::View v;
                     if (getView(*single_elem,v))
-                        lc.add(v);
+                        lc.add(s_.isTrue(cond) ? v : conditionalView(v,cond));
                     else
                         error("VariableView or integer expression expected",*single_elem);
                 }
@@ -504,7 +550,7 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
 
                 if (!op.isFunction())
                     error("l..u expected");
-                if (toString(td_.getTerm(op.function()))==".." && op.size()==2)
+                if (isSymbol(op.function(),"..") && op.size()==2)
                 {
                     if (isNumber(*op.begin()))
                     {
@@ -535,6 +581,14 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
             error("Rhs VariableView expected",*(*i)->rhs());
 
         order::Literal lit = toOrderFormat(lp_->getLiteral((*i)->atom()));
+        if (s_.isTrue(lit) && v.a==1 && v.c==0)
+        {
+            auto it = domains_.find(v.v);
+            if (it == domains_.end())
+                domains_.emplace(v.v,d);
+            else
+                it->second.intersect(d);
+        }
         n_.addConstraint(order::ReifiedDomainConstraint(v,std::move(d),lit));
         break;
     }
@@ -542,13 +596,16 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
     case DISTINCT:
     {
         // ((l..u) or x) = view
-        std::vector<order::View> views;
+        std::vector<std::pair<order::View,order::Literal>> views;
+        bool conditional = false;
         for (auto elemId = (*i)->begin(); elemId != (*i)->end(); ++elemId)
         {
             auto& elem = td_.getElement(*elemId);
-            // check condition of element
-            if (elem.condition()!=0)
-                error("Conditions on theory terms not yet supported");
+            // elements with a false condition are not taken into account
+            order::Literal cond = getCondition(elem);
+            if (s_.isFalse(cond))
+                continue;
+            conditional = conditional || !s_.isTrue(cond);
             //for (auto single_elem = elem.begin(); single_elem != elem.end(); ++single_elem)
             auto single_elem = elem.begin();
             {
@@ -558,7 +615,7 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
 //                std::cout << std::endl;
                 order::View v;
                 if (getView(*single_elem,v))
-                    views.emplace_back(v);
+                    views.emplace_back(v,cond);
                 else
                     error("VariableView expected",*single_elem);
             }
@@ -571,7 +628,21 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
             error("Did not expect a rhs in distinct",*(*i)->rhs());
 
         order::Literal lit = toOrderFormat(lp_->getLiteral((*i)->atom()));
-        n_.addConstraint(order::ReifiedAllDistinct(std::move(views),lit));
+        if (conditional)
+        {
+            /// every element forms its own set, and is only part of it if its condition holds
+            std::vector<std::vector<std::pair<order::View,order::ReifiedDNF>>> sets;
+            for (auto& p : views)
+                sets.emplace_back(std::vector<std::pair<order::View,order::ReifiedDNF>>{std::make_pair(p.first,order::ReifiedDNF({{p.second}}))});
+            n_.addConstraint(order::ReifiedDisjoint(std::move(sets),lit));
+        }
+        else
+        {
+            std::vector<order::View> plain;
+            for (auto& p : views)
+                plain.emplace_back(p.first);
+            n_.addConstraint(order::ReifiedAllDistinct(std::move(plain),lit));
+        }
         break;
     }
         
@@ -593,8 +664,7 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
                 
                 if (op.isFunction())
                 {
-                    auto& term = td_.getTerm(op.function());
-                    if (toString(term)=="/")
+                    if (isSymbol(op.function(),"/"))
                     {
                         if (op.size()==2 && isVariable(*op.begin()) && td_.getTerm(*(op.begin()+1)).type()==Potassco::Theory_t::Number)
                         {
@@ -647,8 +717,7 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
 
             if (op.isFunction())
             {
-                auto& term = td_.getTerm(op.function());
-                if (toString(term)=="@")
+                if (isSymbol(op.function(),"@"))
                 {
                     if (op.size()==2)
                     {
@@ -710,6 +779,22 @@ bool TheoryParser::readConstraint(Potassco::TheoryData::atom_iterator& i)
 std::vector<std::pair<std::string,Clasp::Literal>> TheoryParser::postProcess()
 {
     std::vector<std::pair<std::string,Clasp::Literal>> ret;
+    /// restrict the views of conditional elements to 0 and the values of the conditioned view
+    for (auto& i : conditional_)
+    {
+        auto it = domains_.find(i.second.v);
+        if (it == domains_.end())
+            continue;
+        order::Domain d(it->second);
+        d.inplace_times(i.second.a,n_.getConfig().domSize);
+        if (d.overflow())
+            continue;
+        d += i.second.c;
+        if (d.overflow())
+            continue;
+        d.unify(0,0);
+        n_.addConstraint(ReifiedDomainConstraint(i.first,std::move(d),trueLit_));
+    }
     for (auto i : shownPred_)
     {
         for (uint32 tid = 0; tid != termId2View_.size(); ++tid)
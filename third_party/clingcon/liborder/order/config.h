@@ -49,6 +49,7 @@ public:
     int64 translateConstraints; // translate constraint if expected number of clauses is less than this number (-1 = all)
     int64 minLitsPerVar; // precreate at least this number of literals per variable (-1 = all)
     bool equalityProcessing; // enable equality processing
+    unsigned int translateThreads = 1; // number of threads used to translate constraints into clauses
 };
 
 //for testing
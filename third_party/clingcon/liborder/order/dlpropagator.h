@@ -55,21 +55,23 @@ public:
     /// pre: edge is unknown or already true (does nothing then)
     /// set's this edge to true, sets the opposite edge to false
     /// propagates all true/false edges
-    /// returns a set of edges which have to be false
-    std::vector<EdgeId> activate(EdgeId id);
+    /// consequences is cleared and filled with the edges which have to be false
+    /// (caller provided so it can be reused without allocating)
+    void activate(EdgeId id, std::vector<EdgeId>& consequences);
     
     /// pre, prepare must have been called
     /// pre: edge is unknown or already false (does nothing then)
     /// set's this edge to false, sets the opposite edge to true
     /// (simply calls activate(b,-weight-1,a) )
     /// propagates all true/false edges
-    /// returns a set of edges which have to be false
-    std::vector<EdgeId> deactivate(EdgeId id);
+    /// consequences is cleared and filled with the edges which have to be false
+    void deactivate(EdgeId id, std::vector<EdgeId>& consequences);
     
     
     
     /// is not const because of intrinsic data structure
-    std::vector<EdgeId> reason(EdgeId id);
+    /// reason is cleared and filled with the true edges implying id
+    void reason(EdgeId id, std::vector<EdgeId>& reason);
     
     
     ///pre: number of activate/deactivate calls > undo calls
@@ -157,8 +159,8 @@ private:
     unsigned int level(EdgeId id);
 
     
-    /// returns a set if edges which is true
-    std::vector<EdgeId> propagate(EdgeId id);
+    /// appends a set of edges which is true to ret
+    void propagate(EdgeId id, std::vector<EdgeId>& ret);
 
     using PosWeight = unsigned int;
     /// returns positive weight, adjusted by potential function
@@ -168,7 +170,7 @@ private:
 public:  
     struct Intrusive
     {
-        Intrusive() : data1(0), data2(0), heapIndex(std::numeric_limits<unsigned int>::max()), visited(false) {}
+        Intrusive() : data1(0), data2(0), heapIndex(std::numeric_limits<unsigned int>::max()), visited(false), posRelevant(0), negRelevant(0) {}
         std::vector<HalfEdge> out;
         int64 data1;
         union
@@ -178,6 +180,8 @@ public:
         //int64 data2; /// data can be used for anything
         unsigned int heapIndex; /// primarily used as lookup where the Variable is stored in the heap, if it is stored (need to check again)
         bool visited;
+        unsigned char posRelevant; /// relevancy flags used in propagate, 0 after each function call
+        unsigned char negRelevant;
     };
 private:
     std::vector<Intrusive> outgoing_; /// outgoing edges of a variable (can be used as incoming with weight: -weight-1)
@@ -201,6 +205,13 @@ private:
     
     std::vector<Edge> edges_;
     
+    /// scratch space, only valid during one function call, kept to avoid allocations
+    std::vector<unsigned int> searchHeap_;  /// heap for the shortest path searches in propagate and reason
+    std::vector<unsigned int> changesHeap_; /// heap for the potential updates in nonrec_activate and undo
+    std::vector<Variable> seen_;
+    std::vector<Variable> posRelevant_;
+    std::vector<Variable> negRelevant_;
+    std::vector<int64> tempPosWeights_;
     
 };
 
@@ -80,13 +80,13 @@ private:
     bool propagateSingleStep();
 
     /// computes the min/maximum of the lhs
+    /// and stores the current bounds of the views in lower_/upper_
     std::pair<int64,int64> computeMinMax(const LinearConstraint& l);
 
     /// propagates directly, thinks the constraint is true
     /// can result in an empty domain, if so it returns false
     /// can only handle LE constraints
     /// DOES NOT GUARANTEE A FIXPOINT (just not sure)(but reshedules if not)
-    /// Remarks: uses double for floor/ceil -> to compatible with 64bit integers
     bool propagate_true(const LinearConstraint& l);
 
     /// propagates the truthvalue of the constraint if it can be directly inferred
@@ -97,6 +97,8 @@ private:
     ConstraintStorage storage_;
     CreatingSolver& s_;
     VariableStorage vs_;
+    std::vector<int64> lower_; /// current lower bounds of the views of the constraint in propagation
+    std::vector<int64> upper_; /// current upper bounds of the views of the constraint in propagation
 };
 
 
@@ -107,7 +109,7 @@ public:
     class LinearConstraintClause
     {
     public:
-        LinearConstraintClause(const ReifiedLinearConstraint& l) : constraint_(l), conflict_(false), newLit_(false) {}
+        LinearConstraintClause(const ReifiedLinearConstraint& l) : v_(l.v), conflict_(false), newLit_(false) {}
         using iter = Restrictor::ViewIterator;
         using itervec = std::vector<iter>;
         LitVec getClause(IncrementalSolver &s, VolatileVariableStorage &vs, bool createOnConflict) const;
@@ -128,7 +130,7 @@ public:
         void setConflict(bool b) { conflict_ = b; }
 
     private:
-        const ReifiedLinearConstraint constraint_;
+        Literal v_; /// the reification literal of the constraint
         itervec its_;
         unsigned int conclusion_;
         bool conflict_;
@@ -175,13 +177,13 @@ public:
 private:
     
     /// computes the min/maximum of the lhs
+    /// and stores the current bounds of the views in lower_/upper_
     std::pair<int64,int64> computeMinMax(const LinearConstraint& l, LinearConstraintClause::itervec &clause);
 
     /// propagates directly, thinks the constraint is true
     /// can result in an empty domain, if so it returns false
     /// can only handle LE constraints
     /// DOES NOT GUARANTEE A FIXPOINT (just not sure)(but reshedules if not)
-    /// Remarks: uses double for floor/ceil -> to compatible with 64bit integers
     std::vector<LinearConstraintClause> propagate_true(const ReifiedLinearConstraint& l);
 
     /// propagates the truthvalue of the constraint if it can be directly inferred
@@ -194,6 +196,8 @@ private:
     ConstraintStorage storage_;
     IncrementalSolver& s_;
     VolatileVariableStorage vs_;
+    std::vector<int64> lower_; /// current lower bounds of the views of the constraint in propagation
+    std::vector<int64> upper_; /// current upper bounds of the views of the constraint in propagation
 };
 
 
@@ -23,6 +23,151 @@ class VariableStorage;
 class VolatileVariableStorage;
 class pure_LELiteral_iterator;
 
+/// sorted map from the index of a domain element to its order literal
+/// the entries are stored in contiguous blocks of at most 2*blockSize elements,
+/// a lookup is a binary search on the first keys of the blocks followed by one inside a block
+class LiteralMap
+{
+public:
+    using value_type = std::pair<unsigned int, Literal>;
+private:
+    using Block = std::vector<value_type>;
+    static const std::size_t blockSize = 64;
+public:
+    class const_iterator : public std::iterator<std::bidirectional_iterator_tag, value_type>
+    {
+    public:
+        const_iterator() : blocks_(nullptr), block_(0), pos_(0) {}
+
+        const value_type& operator*() const { return (*blocks_)[block_][pos_]; }
+        const value_type* operator->() const { return &(*blocks_)[block_][pos_]; }
+
+        const_iterator& operator++()
+        {
+            if (++pos_ == (*blocks_)[block_].size())
+            {
+                ++block_;
+                pos_ = 0;
+            }
+            return *this;
+        }
+        const_iterator& operator--()
+        {
+            if (pos_ == 0)
+            {
+                --block_;
+                pos_ = (*blocks_)[block_].size();
+            }
+            --pos_;
+            return *this;
+        }
+
+        bool operator==(const const_iterator& x) const { return block_ == x.block_ && pos_ == x.pos_; }
+        bool operator!=(const const_iterator& x) const { return !(*this == x); }
+    private:
+        friend LiteralMap;
+        const_iterator(const std::vector<Block>* blocks, std::size_t block, std::size_t pos) : blocks_(blocks), block_(block), pos_(pos) {}
+
+        const std::vector<Block>* blocks_;
+        std::size_t block_;
+        std::size_t pos_;
+    };
+    using iterator = const_iterator;
+
+    LiteralMap() : size_(0) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear() { blocks_.clear(); firstKeys_.clear(); size_ = 0; }
+
+    const_iterator begin() const { return const_iterator(&blocks_, 0, 0); }
+    const_iterator end() const { return const_iterator(&blocks_, blocks_.size(), 0); }
+
+    /// first entry with a key not less than key
+    const_iterator lower_bound(unsigned int key) const
+    {
+        std::size_t block = findBlock(key);
+        if (block == blocks_.size())
+            return begin();
+        const Block& b = blocks_[block];
+        return makeIterator(block, std::lower_bound(b.begin(), b.end(), key, less) - b.begin());
+    }
+
+    const_iterator find(unsigned int key) const
+    {
+        auto it = lower_bound(key);
+        return it != end() && it->first == key ? it : end();
+    }
+
+    /// inserts the literal if there is none for key yet, returns true on insertion
+    bool emplace(unsigned int key, const Literal& l)
+    {
+        std::size_t block = findBlock(key);
+        if (block == blocks_.size())
+        {
+            if (blocks_.empty())
+            {
+                blocks_.emplace_back();
+                firstKeys_.emplace_back(key);
+            }
+            block = 0;
+        }
+        Block& b = blocks_[block];
+        auto it = std::lower_bound(b.begin(), b.end(), key, less);
+        if (it != b.end() && it->first == key)
+            return false;
+        b.emplace(it, key, l);
+        firstKeys_[block] = b.front().first;
+        ++size_;
+        if (b.size() > 2*blockSize)
+        {
+            /// split the block in the middle
+            Block upper(b.begin()+blockSize, b.end());
+            b.erase(b.begin()+blockSize, b.end());
+            firstKeys_.emplace(firstKeys_.begin()+block+1, upper.front().first);
+            blocks_.emplace(blocks_.begin()+block+1, std::move(upper));
+        }
+        return true;
+    }
+
+    /// returns the iterator to the next entry
+    const_iterator erase(const_iterator it)
+    {
+        Block& b = blocks_[it.block_];
+        b.erase(b.begin()+it.pos_);
+        --size_;
+        if (b.empty())
+        {
+            blocks_.erase(blocks_.begin()+it.block_);
+            firstKeys_.erase(firstKeys_.begin()+it.block_);
+            return const_iterator(&blocks_, it.block_, 0);
+        }
+        firstKeys_[it.block_] = b.front().first;
+        return makeIterator(it.block_, it.pos_);
+    }
+
+private:
+    static bool less(const value_type& x, unsigned int key) { return x.first < key; }
+
+    /// the block that may contain key, blocks_.size() if key is smaller than all keys
+    std::size_t findBlock(unsigned int key) const
+    {
+        auto it = std::upper_bound(firstKeys_.begin(), firstKeys_.end(), key);
+        return it == firstKeys_.begin() ? blocks_.size() : it - firstKeys_.begin() - 1;
+    }
+
+    const_iterator makeIterator(std::size_t block, std::size_t pos) const
+    {
+        if (pos == blocks_[block].size())
+            return const_iterator(&blocks_, block+1, 0);
+        return const_iterator(&blocks_, block, pos);
+    }
+
+    std::vector<unsigned int> firstKeys_; /// first key of every block
+    std::vector<Block> blocks_;
+    std::size_t size_;
+};
+
 
 
 
@@ -31,7 +176,7 @@ class orderStorage
 public:
     friend pure_LELiteral_iterator;
     using vector = LitVec;
-    using map = std::map<unsigned int, Literal>;
+    using map = LiteralMap;
 private:
     enum store : unsigned int {hasvector=1, hasmap=2};
     unsigned int store_;
@@ -125,11 +270,9 @@ public:
             Literal l(0,false);
             l.flag();
             vector_.resize(maxSize_, l);
-            while(!map_.empty())
-            {
-                vector_[map_.begin()->first] = map_.begin()->second;
-                map_.erase(map_.begin());
-            }
+            for (const auto& i : map_)
+                vector_[i.first] = i.second;
+            map_.clear();
         }
     }
     
@@ -140,8 +283,9 @@ public:
             return vector_[index];
         else
         {
-            assert(map_.find(index)!=map_.end());
-            return map_.find(index)->second;
+            auto it = map_.find(index);
+            assert(it!=map_.end());
+            return it->second;
         }
     }
 };
@@ -9,6 +9,16 @@
 namespace order
 {
 
+/// the clauses of a translated constraint l --> c,
+/// each clause is ~l followed by the negated GE literals of its iterators
+struct ClauseBatch
+{
+    void clear() { iterators.clear(); ends.clear(); }
+
+    std::vector<Restrictor::ViewIterator> iterators;
+    std::vector<std::size_t> ends; /// end index into iterators for each clause
+};
+
 class Translator
 {
 public:
@@ -19,38 +29,24 @@ public:
     /// returns false if addclause fails
     bool doTranslate(VariableCreator &vc, const ReifiedLinearConstraint& l);
 
+    /// enumerate the clauses of the constraint without creating any literals or clauses
+    /// only reads the domains, so it can run concurrently for different constraints
+    void collect(const VariableCreator &vc, const LinearConstraint& c, ClauseBatch& b) const;
 
-private:
+    /// create the collected clauses of l --> c
+    /// returns false if addclause fails
+    bool commit(VariableCreator &vc, Literal l, const ClauseBatch& b);
 
+private:
 
-    bool doTranslateImplication(VariableCreator &vc, Literal l, const LinearConstraint& c);
     CreatingSolver& s_;
     const Config& conf_;
 };
 
-inline bool translate(CreatingSolver& s, VariableCreator& vc, std::vector<ReifiedLinearConstraint>& rl, const Config& conf)
-{
-    Translator t(s, conf);
-
-    uint64 size = conf.translateConstraints == -1 ? std::numeric_limits<uint64>::max() : conf.translateConstraints;
-
-
-    unsigned int num = rl.size();
-    for (unsigned int i = 0; i < num;)
-    {
-        if (rl[i].l.productOfDomainsExceptLastLEx(vc,size))
-        {
-            if (!t.doTranslate(vc,rl[i]))
-                return false;
-            std::swap(rl[i],*(rl.begin()+num-1));
-            --num;
-        }
-        else
-            ++i;
-    }
-    rl.erase(rl.begin()+num,rl.end());
-    return true;
-}
+/// translate all constraints that are expected to be small enough and remove them from rl
+/// the clauses are enumerated by conf.translateThreads threads,
+/// but created in the same order as with a single thread
+bool translate(CreatingSolver& s, VariableCreator& vc, std::vector<ReifiedLinearConstraint>& rl, const Config& conf);
 
 
 }
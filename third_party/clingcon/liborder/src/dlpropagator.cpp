@@ -15,7 +15,8 @@ class MinBinaryHeap
 {
 public:
     /// outgoing[index].data1 is used for comparison
-    MinBinaryHeap(const F& cmp) : compare_(cmp) {}
+    /// vec is scratch storage owned by the caller, it is cleared here and keeps its capacity
+    MinBinaryHeap(const F& cmp, std::vector<unsigned int>& vec) : vec(vec), compare_(cmp) { vec.clear(); }
     
     /// adds a node index to the heap, returns heap index
     void add(unsigned int index)    {
@@ -119,7 +120,7 @@ public:
 
     }
     
-    std::vector<unsigned int> vec; /// indices to outgoing_
+    std::vector<unsigned int>& vec; /// indices to outgoing_
     const F& compare_;
 };
 
@@ -131,7 +132,8 @@ class ExtendedMinBinaryHeap
 {
 public:
     /// outgoing[index].data1 is used for comparison
-    ExtendedMinBinaryHeap(const F& cmp, std::vector<DLPropagator::Intrusive>& outgoing) : compare_(cmp), outgoing_(outgoing) {}
+    /// vec is scratch storage owned by the caller, it is cleared here and keeps its capacity
+    ExtendedMinBinaryHeap(const F& cmp, std::vector<DLPropagator::Intrusive>& outgoing, std::vector<unsigned int>& vec) : vec(vec), compare_(cmp), outgoing_(outgoing) { vec.clear(); }
     
     /// adds a node index to the heap, returns heap index
     void add(unsigned int index)
@@ -247,7 +249,7 @@ public:
 
     }
     
-    std::vector<unsigned int> vec; /// indices to outgoing_
+    std::vector<unsigned int>& vec; /// indices to outgoing_
     const F& compare_;
     std::vector<DLPropagator::Intrusive>& outgoing_;
 };
@@ -265,21 +267,20 @@ DLPropagator::EdgeId DLPropagator::addEdge(Variable a, Weight weight, Variable b
     return edges_.size();
 }
 
-std::vector<DLPropagator::EdgeId> DLPropagator::activate(EdgeId id)
+void DLPropagator::activate(EdgeId id, std::vector<EdgeId>& consequences)
 {
+    consequences.clear();
     if (isTrue(id))
-        return std::vector<DLPropagator::EdgeId>();
+        return;
     activityQueue_.emplace_back(id);
     //assert(!hasNegativeCycle());
     ++currentLevel_;
     nonrec_activate(id);
     ++currentLevel_;
-    auto r = propagate(id);
-    for (const auto& i : r)
-        activityQueue_.emplace_back(i);
+    propagate(id, consequences);
+    activityQueue_.insert(activityQueue_.end(), consequences.begin(), consequences.end());
     activityQueue_.emplace_back(0);
     //assert(!hasNegativeCycle());
-    return r;
 }
 
 void DLPropagator::nonrec_activate(EdgeId id)
@@ -297,7 +298,7 @@ void DLPropagator::nonrec_activate(EdgeId id)
     Weight weight = e.weight;
     
     auto mycomp = [this](const uint64&a, const uint64& b) { return outgoing_[a].data1 < outgoing_[b].data1; };
-    ExtendedMinBinaryHeap<decltype(mycomp)> changes(mycomp, outgoing_);
+    ExtendedMinBinaryHeap<decltype(mycomp)> changes(mycomp, outgoing_, changesHeap_);
     int64 change = potential_[a]+(int64)weight - potential_[b];
     if (change >= 0)
         return;
@@ -322,7 +323,7 @@ void DLPropagator::nonrec_activate(EdgeId id)
             {
                 if (isTrue(i.id))
                 {
-                    int newChange = potential_[var] + int64(i.weight) - potential_[i.vertex];
+                    int64 newChange = potential_[var] + int64(i.weight) - potential_[i.vertex];
                     if (newChange<0)
                     {
                     //changes.emplace(-newChange, std::make_pair(i.vertex,-(-int(potential_[var]) + i.weight)));
@@ -362,18 +363,19 @@ unsigned int DLPropagator::level(EdgeId id)
     return std::abs(truthTable_[abs(id)]);
 }
 
-std::vector<DLPropagator::EdgeId> DLPropagator::deactivate(EdgeId id)
+void DLPropagator::deactivate(EdgeId id, std::vector<EdgeId>& consequences)
 {
-    return activate(-id);
+    activate(-id, consequences);
 }
 
 
- std::vector<DLPropagator::EdgeId> DLPropagator::reason(EdgeId id)
+void DLPropagator::reason(EdgeId id, std::vector<EdgeId>& ret)
  {
-     std::vector<EdgeId> ret;
-     std::vector<Variable> seen;
+     ret.clear();
+     std::vector<Variable>& seen = seen_;
+     seen.clear();
      auto mycomp = [this](const uint64&a, const uint64& b) { return outgoing_[a].data1 < outgoing_[b].data1; };
-     ExtendedMinBinaryHeap<decltype(mycomp)> heap(mycomp, outgoing_);
+     ExtendedMinBinaryHeap<decltype(mycomp)> heap(mycomp, outgoing_, searchHeap_);
      /// compute shortest path from a to b with only using true edges c
      /// level(c) < level(e)
      unsigned int l = level(id);
@@ -450,8 +452,6 @@ std::vector<DLPropagator::EdgeId> DLPropagator::deactivate(EdgeId id)
          outgoing_[i].heapIndex = std::numeric_limits<unsigned int>::max();
          outgoing_[i].visited = false;
      }
-     
-     return ret;
 }
 
 
@@ -480,7 +480,7 @@ void DLPropagator::undo(EdgeId id)
     //auto mycomp = [](const uint64&a, const uint64& b) { return a > b; };
     //std::multimap<uint64,std::pair<Variable,uint64>, decltype(mycomp)> changes(mycomp); /// positive potential change -> (var/negative final potential)
     auto mycomp = [this](const uint64&a, const uint64& b) { return outgoing_[a].data1 < outgoing_[b].data1; };
-    MinBinaryHeap<decltype(mycomp)> changes(mycomp);
+    MinBinaryHeap<decltype(mycomp)> changes(mycomp, changesHeap_);
     
     const auto& newShortest = [&](const Variable& b)
     {
@@ -561,7 +561,31 @@ bool DLPropagator::isUnknown(EdgeId id) const
 }
 
 
-std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
+namespace
+{
+    /// relevancy flags stored in Intrusive, 0: never marked, 1: relevant, 2: was relevant once (already in the list)
+    /// returns true if v was not relevant before
+    inline bool markRelevant(unsigned char& flag, std::vector<DLPropagator::Variable>& list, DLPropagator::Variable v)
+    {
+        if (flag==1)
+            return false;
+        if (flag==0)
+            list.emplace_back(v);
+        flag = 1;
+        return true;
+    }
+
+    /// returns 1 if v was relevant before
+    inline unsigned int unmarkRelevant(unsigned char& flag)
+    {
+        if (flag!=1)
+            return 0;
+        flag = 2;
+        return 1;
+    }
+}
+
+void DLPropagator::propagate(EdgeId id, std::vector<EdgeId>& ret)
 {
     ///TODO: think about a rewrite using the new EdgeId thingy
     Edge e = getEdge(id);
@@ -569,46 +593,39 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
     Variable b = e.out;
     Weight w = e.weight;
     
-   // REWRITE using HEAP
    // REUSE pos/negRelevany, store posPotentialDistance in data1, posRealDistance in data2,
    //         afterwards negPotentialDistance in data1
     
-    std::vector<Variable> seen;
+    std::vector<Variable>& seen = seen_;
+    seen.clear();
     
     
     /// compute all "relevant" shortest path from a->
-    std::unordered_set<Variable> posRelevancy; /// relevant variables in the positive graph
-    //auto myposcomp = [&posRelevancy](const uint64&a, const uint64& b) { return a < b || (a==b && posRelevancy.find(a)==posRelevancy.end() && posRelevancy.find(b)!=posRelevancy.end()); };
-    //std::multimap<uint64,Variable, decltype(myposcomp)> posQueue(myposcomp); /// potential distance from a to value == key, this is the queue
-    //std::unordered_map<Variable,std::pair<uint64,int64>> posDistance; /// distance from a to Key, first: potential distance, second: real distance
-    auto myposcomp = [this, &posRelevancy](const uint64&a, const uint64& b)
+    /// relevant variables in the positive graph are flagged in outgoing_[x].posRelevant and collected in posRelevant_
+    std::vector<Variable>& posRelevancy = posRelevant_;
+    posRelevancy.clear();
+    auto myposcomp = [this](const uint64&a, const uint64& b)
     {
         if (outgoing_[a].data1 < outgoing_[b].data1)
             return true;
         if (outgoing_[a].data1 == outgoing_[b].data1)
-            return (posRelevancy.find(a)==posRelevancy.end() && posRelevancy.find(b)!=posRelevancy.end());
+            return outgoing_[a].posRelevant!=1 && outgoing_[b].posRelevant==1;
         return false;
     };
-    ExtendedMinBinaryHeap<decltype(myposcomp)> posQueue(myposcomp, outgoing_);
-    
-    std::vector<EdgeId> ret;
+    ExtendedMinBinaryHeap<decltype(myposcomp)> posQueue(myposcomp, outgoing_, searchHeap_);
     
     unsigned int posChecks = 0;
     outgoing_[a].data1=0;
     outgoing_[a].data2=0;
     outgoing_[a].visited=true;
     posQueue.add(a);
-    //posQueue.emplace(0,a);
-    //posDistance.emplace(a,std::make_pair(0,0));
     
     outgoing_[b].data1=weight(a,w,b);
     outgoing_[b].data2=w;
     outgoing_[b].visited=true;
     posQueue.add(b);
-    //posQueue.emplace(weight(a,w,b),b);
-    //posDistance.emplace(b,std::make_pair(weight(a,w,b),w));
     
-    posRelevancy.insert(b);
+    markRelevant(outgoing_[b].posRelevant, posRelevancy, b);
     seen.emplace_back(a);
     seen.emplace_back(b);
     
@@ -619,7 +636,7 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
         Variable x = posQueue.getSmallest();
         posQueue.popSmallest();
         
-        int relevant = posRelevancy.count(x);
+        bool relevant = outgoing_[x].posRelevant==1;
         
         if (relevant)
             --numRelevantInQueue;
@@ -631,7 +648,6 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
             {
                 PosWeight w = weight(x,out.weight,next);
                 int currentDistIndex = posQueue.isInside(next);
-                //if (currentDist == posDistance.end() || currentDist->second.first>posDistance[x].first+w)
                 if (currentDistIndex < 0)
                 {
                     if (!outgoing_[next].visited)
@@ -643,16 +659,10 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
                         outgoing_[next].visited = true;
                         seen.emplace_back(next);
                         /// propagate relevancy
-                        if (posRelevancy.count(x))
-                        {
-                            if (posRelevancy.count(next)==0)
-                            {
-                                ++numRelevantInQueue;
-                                posRelevancy.insert(next);
-                            }
-                        }
+                        if (relevant)
+                            numRelevantInQueue += markRelevant(outgoing_[next].posRelevant, posRelevancy, next);
                         else
-                            numRelevantInQueue-=posRelevancy.erase(next);
+                            numRelevantInQueue -= unmarkRelevant(outgoing_[next].posRelevant);
                     }
                     
                 }
@@ -664,16 +674,10 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
                     outgoing_[next].data2 = outgoing_[x].data2+out.weight;
                     posQueue.moveUp(currentDistIndex);
                     /// propagate relevancy
-                    if (posRelevancy.count(x))
-                    {
-                        if (posRelevancy.count(next)==0)
-                        {
-                            ++numRelevantInQueue;
-                            posRelevancy.insert(next);
-                        }
-                    }
+                    if (relevant)
+                        numRelevantInQueue += markRelevant(outgoing_[next].posRelevant, posRelevancy, next);
                     else
-                        numRelevantInQueue-=posRelevancy.erase(next);
+                        numRelevantInQueue -= unmarkRelevant(outgoing_[next].posRelevant);
                 }
             }
             else
@@ -684,12 +688,8 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
         }
     }
 
-//    for (const auto& i : posRelevancy)
-//    {
-//        std::cout << "Reachable " << i << " with weight " << outgoing_[i].data2 << std::endl;
-//    }
-
-    std::vector<int64> tempPosWeights;  ///vector to store real weights of pos in order of posRelevancy
+    std::vector<int64>& tempPosWeights = tempPosWeights_;  ///vector to store real weights of pos in order of posRelevancy
+    tempPosWeights.clear();
     for (const auto& i : posRelevancy)
         tempPosWeights.push_back(outgoing_[i].data2);
     
@@ -703,19 +703,18 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
 
     
     /// compute all relevant shortest path from <-b backwards
-    std::unordered_set<Variable> negRelevancy; /// relevant variables in the positive graph
-//    auto mynegcomp = [&negRelevancy](const uint64&a, const uint64& b) { return a < b || (a==b && negRelevancy.find(a)==negRelevancy.end() && negRelevancy.find(b)!=negRelevancy.end()); };
-//    std::multimap<uint64,Variable, decltype(mynegcomp)> negQueue(mynegcomp); /// distance from a to value == key, this is the queue
-//    std::unordered_map<Variable,std::pair<uint64,int64>> negDistance; /// distance from Key to b by going backwards through the edges, first: potential distance, second: real distance
-    auto mynegcomp = [this, &negRelevancy](const uint64&a, const uint64& b)
+    /// relevant variables in the negative graph are flagged in outgoing_[x].negRelevant and collected in negRelevant_
+    std::vector<Variable>& negRelevancy = negRelevant_;
+    negRelevancy.clear();
+    auto mynegcomp = [this](const uint64&a, const uint64& b)
     {
         if (outgoing_[a].data1 < outgoing_[b].data1)
             return true;
         if (outgoing_[a].data1 == outgoing_[b].data1)
-           return (negRelevancy.find(a)==negRelevancy.end() && negRelevancy.find(b)!=negRelevancy.end());
+           return outgoing_[a].negRelevant!=1 && outgoing_[b].negRelevant==1;
         return false;
     };
-    ExtendedMinBinaryHeap<decltype(mynegcomp)> negQueue(mynegcomp, outgoing_);
+    ExtendedMinBinaryHeap<decltype(mynegcomp)> negQueue(mynegcomp, outgoing_, searchHeap_);
     
     
     unsigned int negChecks = 0;
@@ -734,7 +733,7 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
     seen.emplace_back(a);
     
     
-    negRelevancy.insert(a);
+    markRelevant(outgoing_[a].negRelevant, negRelevancy, a);
     
     numRelevantInQueue=1;
     while(numRelevantInQueue>0)
@@ -743,7 +742,7 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
         Variable x = negQueue.getSmallest();
         negQueue.popSmallest();
         
-        int relevant = negRelevancy.count(x);
+        bool relevant = outgoing_[x].negRelevant==1;
         if (relevant)
             --numRelevantInQueue;
             
@@ -765,16 +764,10 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
                         negQueue.add(next);
                         seen.emplace_back(next);
                         /// propagate relevancy
-                        if (negRelevancy.count(x))
-                        {
-                            if (negRelevancy.count(next)==0)
-                            {
-                                ++numRelevantInQueue;
-                                negRelevancy.insert(next);
-                            }
-                        }
+                        if (relevant)
+                            numRelevantInQueue += markRelevant(outgoing_[next].negRelevant, negRelevancy, next);
                         else
-                            numRelevantInQueue-=negRelevancy.erase(next);
+                            numRelevantInQueue -= unmarkRelevant(outgoing_[next].negRelevant);
                     }
                     
                 }
@@ -786,16 +779,10 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
                     outgoing_[next].data2 = outgoing_[x].data2-out.weight-1;
                     negQueue.moveUp(currentDistIndex);
                     /// propagate relevancy
-                    if (negRelevancy.count(x))
-                    {
-                        if (negRelevancy.count(next)==0)
-                        {
-                            ++numRelevantInQueue;
-                            negRelevancy.insert(next);
-                        }
-                    }
+                    if (relevant)
+                        numRelevantInQueue += markRelevant(outgoing_[next].negRelevant, negRelevancy, next);
                     else
-                        numRelevantInQueue-=negRelevancy.erase(next);
+                        numRelevantInQueue -= unmarkRelevant(outgoing_[next].negRelevant);
                 }
             }
             else
@@ -810,11 +797,6 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
     for (const auto& i : posRelevancy)
         outgoing_[i].data1 = tempPosWeights[k++];
 
-//    for (const auto& i : negRelevancy)
-//    {
-//        std::cout << "Reachable " << i << " with weight " << outgoing_[i].data2 << std::endl;
-//    }
-    
     for (const auto& i : seen)
     {
         outgoing_[i].heapIndex = std::numeric_limits<unsigned int>::max();
@@ -828,12 +810,13 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
     {
         for (const auto& i : posRelevancy)
         {
+            if (outgoing_[i].posRelevant!=1)
+                continue;
             for (const auto& out : outgoing_[i].out)
             {
                 if (isUnknown(out.id))
                 {
-                    //std::cout << negDistance[out.vertex].second << " + " << posDistance[i].second << " - " << w << " + " <<   out.weight << " < " <<  0 << std::endl;
-                    if (negRelevancy.find(out.vertex)!=negRelevancy.end() && outgoing_[i].data1 + outgoing_[out.vertex].data2 - w + out.weight < 0 )
+                    if (outgoing_[out.vertex].negRelevant==1 && outgoing_[i].data1 + outgoing_[out.vertex].data2 - w + out.weight < 0 )
                     {
                         //FOUND
                         nonrec_activate(-out.id);
@@ -847,12 +830,13 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
     {
         for (const auto& i : negRelevancy)
         {
+            if (outgoing_[i].negRelevant!=1)
+                continue;
             for (const auto& out : outgoing_[i].out) /// incoming
             {
                 if (isUnknown(-out.id))
                 {
-                    //std::cout << negDistance[i].second << " + " << posDistance[out.vertex].second << " - " << w << " + " << -out.weight-1 << " < " <<  0 << std::endl;
-                    if (posRelevancy.find(out.vertex)!=negRelevancy.end() && (int64)(outgoing_[i].data2 + outgoing_[out.vertex].data1 - w + (-out.weight-1) < 0 ))
+                    if (outgoing_[out.vertex].posRelevant==1 && (int64)(outgoing_[i].data2 + outgoing_[out.vertex].data1 - w + (-out.weight-1) < 0 ))
                     {
                         //FOUND
                         nonrec_activate(out.id);
@@ -863,7 +847,10 @@ std::vector<DLPropagator::EdgeId> DLPropagator::propagate(EdgeId id)
         }
     }
     
-    return ret;
+    for (const auto& i : posRelevancy)
+        outgoing_[i].posRelevant = 0;
+    for (const auto& i : negRelevancy)
+        outgoing_[i].negRelevant = 0;
 }
 
 
@@ -122,7 +122,7 @@ LitVec LinearLiteralPropagator::LinearConstraintClause::getClause(IncrementalSol
             
         }
     }
-    ret.emplace_back(~constraint_.v);
+    ret.emplace_back(~v_);
     return ret;
 }
 
@@ -291,34 +291,52 @@ std::vector<LinearLiteralPropagator::LinearConstraintClause> LinearLiteralPropag
 }
 
 
+namespace
+{
+/// sums up the bounds of all views, kept as two plain loops over
+/// contiguous arrays so that the compiler can vectorize them
+std::pair<int64,int64> sumBounds(const std::vector<int64>& lower, const std::vector<int64>& upper)
+{
+    int64 min = 0;
+    for (auto i : lower)
+        min += i;
+    int64 max = 0;
+    for (auto i : upper)
+        max += i;
+    return std::make_pair(min,max);
+}
+}
+
 std::pair<int64,int64> LinearPropagator::computeMinMax(const LinearConstraint& l)
 {
-    auto views = l.getViews();
-    std::pair<int64,int64> minmax(0,0);
-    for (auto i : views)
+    const auto& views = l.getViews();
+    lower_.resize(views.size());
+    upper_.resize(views.size());
+    for (std::size_t i = 0; i < views.size(); ++i)
     {
-        auto r = vs_.getCurrentRestrictor(i);
-        minmax.first += r.lower();
-        minmax.second += r.upper();
+        auto r = vs_.getCurrentRestrictor(views[i]);
+        lower_[i] = r.lower();
+        upper_[i] = r.upper();
     }
-    return minmax;
+    return sumBounds(lower_, upper_);
 }
 
 
 std::pair<int64,int64> LinearLiteralPropagator::computeMinMax(const LinearConstraint& l, LinearConstraintClause::itervec& clause)
 {
-    auto views = l.getViews();
-    std::pair<int64,int64> minmax(0,0);
-
-    for (auto i : views)
+    const auto& views = l.getViews();
+    lower_.resize(views.size());
+    upper_.resize(views.size());
+    clause.reserve(views.size());
+    for (std::size_t i = 0; i < views.size(); ++i)
     {
-        auto r = vs_.getVariableStorage().getCurrentRestrictor(i);
+        auto r = vs_.getVariableStorage().getCurrentRestrictor(views[i]);
         assert(!r.isEmpty());
-        minmax.first += r.lower();
-        minmax.second += r.upper();
+        lower_[i] = r.lower();
+        upper_[i] = r.upper();
         clause.emplace_back(r.begin());
     }
-    return minmax;
+    return sumBounds(lower_, upper_);
 }
 
 
@@ -329,28 +347,29 @@ bool LinearPropagator::propagate_true(const LinearConstraint& l)
     if (minmax.second <= l.getRhs())
         return true;
 
-    for (auto i : l.getViews())
+    const auto& views = l.getViews();
+    for (std::size_t index = 0; index < views.size(); ++index)
     {
-        auto r = vs_.getCurrentRestrictor(i);
+        auto& i = views[index];
         auto wholeRange = vs_.getRestrictor(i); 
         std::pair<int64,int64> mm;
-        mm.first = minmax.first - r.lower();
-        mm.second = minmax.second - r.upper();
+        mm.first = minmax.first - lower_[index];
+        mm.second = minmax.second - upper_[index];
 
             int64 up = l.getRhs() - mm.first;
-            if (up < r.lower())
+            if (up < lower_[index])
             {
                 //std::cout << "Constrain Variable " << i.first << " with new upper bound " << up << std::endl;
                 return false;
             }
-            if (up < r.upper())
+            if (up < upper_[index])
             {
                 //std::cout << "Constrain Variable " << i.first << " with new upper bound " << up << std::endl;
                 //auto newUpper = std::lower_bound(wholeRange.begin(), wholeRange.end(), up);
                 auto newUpper = std::upper_bound(wholeRange.begin(), wholeRange.end(), up);
                 if (!constrainUpperBound(newUpper)) // +1 is needed, as it is in iterator pointing after the element
                     return false;
-                minmax.first = mm.first + r.lower();
+                minmax.first = mm.first + lower_[index];
                 minmax.second = mm.second + *(newUpper-1);
             }
     }
@@ -368,16 +387,15 @@ std::vector<LinearLiteralPropagator::LinearConstraintClause> LinearLiteralPropag
         return ret;
 
     //std::cout << "trying to propagate " << l << std::endl;
-    auto views = l.getViews();
+    const auto& views = l.getViews();
     for (std::size_t index=0; index < views.size(); ++index)
     {
         auto& i = views[index];
         auto wholeRange = vs_.getVariableStorage().getRestrictor(i);
         assert(wholeRange.size()>0);
-        auto r = vs_.getVariableStorage().getCurrentRestrictor(i);
         std::pair<int64,int64> mm;
-        mm.first = minmax.first - r.lower();
-        mm.second = minmax.second - r.upper();
+        mm.first = minmax.first - lower_[index];
+        mm.second = minmax.second - upper_[index];
         
         //Literal prop = s_.falseLit();
         bool prop = false;
@@ -396,7 +414,7 @@ std::vector<LinearLiteralPropagator::LinearConstraintClause> LinearLiteralPropag
             conflict = true;
         }
         else
-            if (up < r.upper())
+            if (up < upper_[index])
             {
                 //std::cout << "Constrain Variable " << i.v << "*" << i.a << "+" << i.c << " with new upper bound " << up << std::endl;
                 auto newUpper = std::upper_bound(wholeRange.begin(), wholeRange.end(), up, [](int64 val, int64 it){ return it > val; });
@@ -413,7 +431,7 @@ std::vector<LinearLiteralPropagator::LinearConstraintClause> LinearLiteralPropag
                     prop = true;
                     //prop = vs_.getVariableCreator().getLiteral(newUpper);
                     conflict = !constrainUpperBound((newUpper+1)); // +1 is needed, as it is an iterator pointing after the element
-                    minmax.first = mm.first + r.lower();
+                    minmax.first = mm.first + lower_[index];
                     minmax.second =  mm.second + *newUpper;
                     //minmax = mm + std::minmax(i.second*(int64)r.lower(),i.second*(int64)((*newUpper)));
                 }
@@ -346,22 +346,25 @@ bool VariableCreator::domainChange(const Variable& var, int newLower, int newUpp
         if (orderLitMemory_[var].hasMap())
         {
             orderStorage::map& m = orderLitMemory_[var].getMap();
-            for (auto h = m.begin(); h != m.end(); ++h)
+            for (auto h = m.begin(); h != m.end();)
             {
                 /// everyting before start to false
                 if (h->first < start)
                 {
                     if (!s_.createClause(LitVec{~(h->second)}))
                         return false;
-                    m.erase(h);
+                    h = m.erase(h);
                 }
+                else
                 /// everyting after end to true
                 if (h->first >= end)
                 {
                     if (!s_.createClause(LitVec{h->second}))
                         return false;
-                    m.erase(h);
+                    h = m.erase(h);
                 }
+                else
+                    ++h;
             }
         }
         else
@@ -445,13 +448,13 @@ bool VariableCreator::domainChange(const Variable& var, const Domain& d)
         {
             auto& m = orderLitMemory_[var].getMap();
             auto k = keep.begin()+1;
-            for (auto h = m.begin(); h != m.end(); ++h)
+            for (auto h = m.begin(); h != m.end();)
             {
                 /// everyting before start to false
                 if (h->first < start)
                 {
                     Literal l = h->second;
-                    m.erase(h);
+                    h = m.erase(h);
                     if (!s_.createClause(LitVec{~l}))
                         return false;
                 }
@@ -461,16 +464,16 @@ bool VariableCreator::domainChange(const Variable& var, const Domain& d)
                     if (h->first >= end)
                     {
                         Literal l = h->second;
-                        m.erase(h);
+                        h = m.erase(h);
                         if (!s_.createClause(LitVec{l}))
                             return false;
                     }
                     else
                     {
                         if (h->first >= *k-r.begin() && h->first < (*(k+1))-r.begin())
-                        {
-                            m.erase(h);
-                        }
+                            h = m.erase(h);
+                        else
+                            ++h;
                     }
                 }
             }
@@ -1,5 +1,7 @@
 #include "translator.h"
 #include "solver.h"
+#include <atomic>
+#include <thread>
 
 ///TODO: how does gringo get the names !
 namespace order
@@ -33,8 +35,11 @@ std::pair<int64, int64> operator +(const std::pair<int64, int64>& x, const std::
 bool Translator::doTranslate(VariableCreator& vc, const ReifiedLinearConstraint& l)
 {
     if (!s_.isFalse(l.v))
-        if (!doTranslateImplication(vc, l.v,l.l)) /// l.v --> l
-            return false;
+    {
+        ClauseBatch b;
+        collect(vc, l.l, b); /// l.v --> l
+        return commit(vc, l.v, b);
+    }
     return true;
 }
 
@@ -43,30 +48,24 @@ namespace {
 class ClauseChecker
 {
 public:
-    ClauseChecker(CreatingSolver& s, const Config& conf, VariableCreator& vc) : s_(s), check_(conf.redundantClauseCheck), vc_(vc) {}
-    void emplace_back(const Literal& l) { currentClause_.emplace_back(l); }
+    ClauseChecker(const Config& conf, ClauseBatch& b) : batch_(b), check_(conf.redundantClauseCheck) {}
     void add(Restrictor::ViewIterator& i)
     {
-        currentClause_.emplace_back(~vc_.getGELiteral(i));
-        if(check_)
-            currentIterators_.emplace_back(i);
+        currentIterators_.emplace_back(i);
     }
 
     
     void pop_back()
     {
-        assert(currentClause_.size()>1);/// first literal should never be popped
-        currentClause_.pop_back();
-        if(check_)
-            currentIterators_.pop_back();
+        assert(currentIterators_.size()>0);
+        currentIterators_.pop_back();
     }
 
     /// always remember that comparing two clauses is only allowed if the differ in size only on the last variables
-    bool createClause()
+    void createClause()
     {
         if(check_)
         {
-            assert(lastIterators_.empty() || (currentClause_.size() == currentIterators_.size()+1));
             bool relaxed = false;
             bool restrictive = false;
             if (lastIterators_.size()<currentIterators_.size()) restrictive = true;
@@ -91,21 +90,20 @@ public:
             if (restrictive && !relaxed && !(lastIterators_.size()==0))
             {
                 //std::cout << "Could be SAVED" << std::endl;
-                return true; // redundant
+                return; // redundant
             }
 
             lastIterators_ = currentIterators_;
         }
-        return s_.createClause(currentClause_);
+        batch_.iterators.insert(batch_.iterators.end(), currentIterators_.begin(), currentIterators_.end());
+        batch_.ends.emplace_back(batch_.iterators.size());
     }
 private:
        
-    CreatingSolver& s_;
-    LitVec currentClause_; // the clause currently building up
-    std::vector<Restrictor::ViewIterator> currentIterators_; // the current iterator set representing the currentClause_
+    ClauseBatch& batch_;
+    std::vector<Restrictor::ViewIterator> currentIterators_; // the current iterator set representing the current clause
     std::vector<Restrictor::ViewIterator> lastIterators_;
     bool check_; // true if redundant clause check is enabled
-    VariableCreator& vc_;
 
 };
 
@@ -121,7 +119,7 @@ public:
         vc(vc), c(c), subsums(subsums), clause(clause) {}
 
 
-    bool recTrans(int64 current, std::size_t index)
+    void recTrans(int64 current, std::size_t index)
     {
         const std::vector<View>& views = c.getViews();
         View view = views[index];
@@ -137,21 +135,17 @@ public:
             clause.add(i);
             if (newcurrent+subsums[index+1].first<=(int64)c.getRhs()) // if we need to add more to be greater than the bound
             {
-                if (!recTrans(newcurrent, index+1))
-                    return false;
+                recTrans(newcurrent, index+1);
                 clause.pop_back();
             }
             else
             {
-                if (!clause.createClause())
-                    return false;
+                clause.createClause();
                 clause.pop_back();
-                return true;
+                return;
             }
             ++i;
         }
-                
-        return true;
     }
 
 private:
@@ -164,10 +158,9 @@ private:
 
 }
 
-bool Translator::doTranslateImplication(VariableCreator &vc, Literal l, const LinearConstraint& c)
+void Translator::collect(const VariableCreator &vc, const LinearConstraint& c, ClauseBatch& b) const
 {
-    ClauseChecker clause(s_, conf_, vc);
-    clause.emplace_back(~l);
+    ClauseChecker clause(conf_, b);
     auto views = c.getViews();
 
     std::pair<int64,int64> minmax(0,0);
@@ -183,8 +176,88 @@ bool Translator::doTranslateImplication(VariableCreator &vc, Literal l, const Li
     subsums.emplace_back(std::make_pair(0,0));
 
     RecTrans r(vc,c,subsums,clause);
-    if (!r.recTrans(0, 0))
-        return false;
+    r.recTrans(0, 0);
+}
+
+bool Translator::commit(VariableCreator &vc, Literal l, const ClauseBatch& b)
+{
+    LitVec clause;
+    std::size_t begin = 0;
+    for (auto end : b.ends)
+    {
+        clause.clear();
+        clause.emplace_back(~l);
+        for (; begin != end; ++begin)
+            clause.emplace_back(~vc.getGELiteral(b.iterators[begin]));
+        if (!s_.createClause(clause))
+            return false;
+    }
+    return true;
+}
+
+bool translate(CreatingSolver& s, VariableCreator& vc, std::vector<ReifiedLinearConstraint>& rl, const Config& conf)
+{
+    Translator t(s, conf);
+
+    uint64 size = conf.translateConstraints == -1 ? std::numeric_limits<uint64>::max() : conf.translateConstraints;
+
+    /// select the constraints to translate, in the order they have always been translated
+    std::vector<ReifiedLinearConstraint> selected;
+    unsigned int num = rl.size();
+    for (unsigned int i = 0; i < num;)
+    {
+        if (rl[i].l.productOfDomainsExceptLastLEx(vc,size))
+        {
+            selected.emplace_back(std::move(rl[i]));
+            std::swap(rl[i],*(rl.begin()+num-1));
+            --num;
+        }
+        else
+            ++i;
+    }
+    rl.erase(rl.begin()+num,rl.end());
+
+    unsigned int threads = std::max(conf.translateThreads, 1u);
+    if (threads == 1 || selected.size() < 2)
+    {
+        for (auto& i : selected)
+            if (!t.doTranslate(vc,i))
+                return false;
+        return true;
+    }
+
+    /// domain sizes are computed lazily, cache them before the domains are shared
+    for (Variable v = 0; v != vc.numVariables(); ++v)
+        if (vc.isValid(v))
+            vc.getDomainSize(View(v));
+
+    /// enumerate the clauses of a chunk in parallel, create them in order afterwards,
+    /// literals are created on demand and only by this thread
+    std::size_t chunk = threads * 64;
+    std::vector<ClauseBatch> batches(std::min(chunk, selected.size()));
+    for (std::size_t begin = 0; begin < selected.size(); begin += chunk)
+    {
+        std::size_t end = std::min(begin + chunk, selected.size());
+        std::atomic<std::size_t> next(begin);
+        auto work = [&]()
+        {
+            for (std::size_t i = next++; i < end; i = next++)
+            {
+                batches[i-begin].clear();
+                t.collect(vc, selected[i].l, batches[i-begin]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned int j = 1; j < std::min<std::size_t>(threads, end-begin); ++j)
+            pool.emplace_back(work);
+        work();
+        for (auto& j : pool)
+            j.join();
+
+        for (std::size_t i = begin; i != end; ++i)
+            if (!s.isFalse(selected[i].v) && !t.commit(vc, selected[i].v, batches[i-begin]))
+                return false;
+    }
     return true;
 }
 
@@ -48,12 +48,18 @@ public:
 
 private:
     void printTerm(Potassco::Id_t termId);
+    void append(int64_t num);
+    void flush();
+    static bool markSeen(std::vector<bool> &seen, Potassco::Id_t id);
 
 private:
     Potassco::TheoryData const &data_;
     std::ostream &out_;
     std::vector<bool> seenTerms_;
     std::vector<bool> seenElems_;
+    // terms being printed paired with the index of the next child to visit
+    std::vector<std::pair<Potassco::Id_t, uint32_t>> stack_;
+    std::string buf_;
 };
 
 class SmodelsFormatBackend : public Backend {
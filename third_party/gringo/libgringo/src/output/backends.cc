@@ -71,6 +71,7 @@ void IntermediateFormatBackend::beginStep() {
 }
 
 void IntermediateFormatBackend::printHead(bool choice, AtomVec const &atoms) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Rule << " " << (choice ? Potassco::Head_t::Choice : Potassco::Head_t::Disjunctive) << " " << p(atoms);
 }
 
@@ -83,87 +84,152 @@ void IntermediateFormatBackend::printWeightBody(Potassco::Weight_t lower, LitWei
 }
 
 void IntermediateFormatBackend::printMinimize(int priority, LitWeightVec const &body) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Minimize << " " << priority << " " << p(body) << "\n";
 }
 
 void IntermediateFormatBackend::printProject(AtomVec const &lits) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Project << " " << p(lits) << "\n";
 }
 
 void IntermediateFormatBackend::printOutput(char const *value, LitVec const &body) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Output << " " << strlen(value) << " " << value << " " << p(body) << "\n";
 }
 
 void IntermediateFormatBackend::printEdge(unsigned u, unsigned v, LitVec const &body) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Edge << " " << u << " " << v << " " << p(body) << "\n";
 }
 
 void IntermediateFormatBackend::printHeuristic(Potassco::Heuristic_t modifier, Potassco::Atom_t atom, int value, unsigned priority, LitVec const &body) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Heuristic << " " << modifier << " " << atom << " " << value << " " << priority << " " << p(body) << "\n";
 }
 
 void IntermediateFormatBackend::printExternal(Potassco::Atom_t atom, Potassco::Value_t value) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::External << " " << atom << " " << value << "\n";
 }
 
 void IntermediateFormatBackend::printAssume(LitVec const &lits) {
+    if (!buf_.empty()) { flush(); }
     out_ << Potassco::Directive_t::Assume << " " << p(lits) << "\n";
 }
 
 void IntermediateFormatBackend::endStep() {
+    if (!buf_.empty()) { flush(); }
     out_ << "0\n";
 }
 
+void IntermediateFormatBackend::flush() {
+    out_.write(buf_.data(), buf_.size());
+    buf_.clear();
+}
+
+void IntermediateFormatBackend::append(int64_t num) {
+    char tmp[24];
+    char *end = tmp + sizeof(tmp), *pos = end;
+    uint64_t abs = num < 0 ? -static_cast<uint64_t>(num) : static_cast<uint64_t>(num);
+    do { *--pos = static_cast<char>('0' + abs % 10); } while (abs /= 10);
+    if (num < 0) { *--pos = '-'; }
+    buf_.push_back(' ');
+    buf_.append(pos, end);
+}
+
+bool IntermediateFormatBackend::markSeen(std::vector<bool> &seen, Potassco::Id_t id) {
+    if (seen.size() <= id) { seen.resize(std::max<size_t>(id + 1, 2 * seen.size()), false); }
+    if (seen[id]) { return false; }
+    seen[id] = true;
+    return true;
+}
+
 void IntermediateFormatBackend::printTerm(Potassco::Id_t termId) {
-    if (seenTerms_.size() <= termId) { seenTerms_.resize(termId + 1, false); }
-    if (!seenTerms_[termId]) {
-        seenTerms_[termId] = true;
-        auto &term = data_.getTerm(termId);
+    // Note: terms are emitted in post-order using an explicit stack
+    //       because deeply nested terms could overflow the call stack;
+    //       the children of a compound, its arguments followed by its function,
+    //       are visited one at a time so that each child is emitted before
+    //       any term visited after it, as a recursive traversal would do
+    if (!markSeen(seenTerms_, termId)) { return; }
+    stack_.clear();
+    stack_.emplace_back(termId, 0);
+    while (!stack_.empty()) {
+        auto &top = stack_.back();
+        auto id = top.first;
+        auto &term = data_.getTerm(id);
+        if (term.type() == Potassco::Theory_t::Compound && top.second < term.size() + term.isFunction()) {
+            auto child = top.second < term.size() ? term.begin()[top.second] : term.function();
+            ++top.second;
+            // Note: top is invalidated by emplace_back
+            if (markSeen(seenTerms_, child)) { stack_.emplace_back(child, 0); }
+            continue;
+        }
+        stack_.pop_back();
+        buf_.push_back(static_cast<char>('0' + Potassco::Directive_t::Theory));
         switch (term.type()) {
             case Potassco::Theory_t::Number: {
-                out_ << Potassco::Directive_t::Theory << " " << Potassco::Theory_t::Number << " " << termId << " " << term.number() << "\n";
+                append(Potassco::Theory_t::Number);
+                append(id);
+                append(term.number());
                 break;
             }
             case Potassco::Theory_t::Symbol: {
-                out_ << Potassco::Directive_t::Theory<< " " << Potassco::Theory_t::Symbol << " " << termId << " " << std::strlen(term.symbol()) << " " << term.symbol() << "\n";
+                auto len = std::strlen(term.symbol());
+                append(Potassco::Theory_t::Symbol);
+                append(id);
+                append(len);
+                buf_.push_back(' ');
+                buf_.append(term.symbol(), len);
                 break;
             }
             case Potassco::Theory_t::Compound: {
-                for (auto &termId : term) { printTerm(termId); }
-                if (term.isFunction()) { printTerm(term.function()); }
-                out_ << Potassco::Directive_t::Theory << " " << Potassco::Theory_t::Compound << " " << termId << " " << term.compound() << " " << term.size();
-                for (auto &termId : term) { out_ << " " << termId; }
-                out_ << "\n";
+                append(Potassco::Theory_t::Compound);
+                append(id);
+                append(term.compound());
+                append(term.size());
+                for (auto &arg : term) { append(arg); }
                 break;
             }
         }
+        buf_.push_back('\n');
     }
 }
 
 void IntermediateFormatBackend::printTheoryAtom(Potassco::TheoryAtom const &atom, GetCond getCond) {
     printTerm(atom.term());
     for (auto &elemId : atom) {
-        if (seenElems_.size() <= elemId) { seenElems_.resize(elemId + 1, false); }
-        if (!seenElems_[elemId]) {
-            seenElems_[elemId] = true;
+        if (markSeen(seenElems_, elemId)) {
             auto &elem = data_.getElement(elemId);
             for (auto &termId : elem) { printTerm(termId); }
             LitVec cond = getCond(elemId);
-            out_ << Potassco::Directive_t::Theory << " " << Potassco::Theory_t::Element << " " << elemId << " " << elem.size();
-            for (auto &termId : elem) { out_ << " " << termId; }
-            out_ << " " << cond.size();
-            for (auto &lit : cond) { out_ << " " << lit; }
-            out_ << "\n";
+            buf_.push_back(static_cast<char>('0' + Potassco::Directive_t::Theory));
+            append(Potassco::Theory_t::Element);
+            append(elemId);
+            append(elem.size());
+            for (auto &termId : elem) { append(termId); }
+            append(cond.size());
+            for (auto &lit : cond) { append(lit); }
+            buf_.push_back('\n');
         }
     }
     if (atom.guard()) {
         printTerm(*atom.rhs());
         printTerm(*atom.guard());
     }
-    out_ << Potassco::Directive_t::Theory << " " << (atom.guard() ? Potassco::Theory_t::AtomWithGuard : Potassco::Theory_t::Atom) << " " << atom.atom() << " " << atom.occurrence() << " " << atom.term() << " " << atom.size();
-    for (auto &elemId : atom) { out_ << " " << elemId; }
-    if (atom.guard()) { out_ << " " << *atom.guard() << " " << *atom.rhs(); }
-    out_ << "\n";
+    buf_.push_back(static_cast<char>('0' + Potassco::Directive_t::Theory));
+    append(atom.guard() ? Potassco::Theory_t::AtomWithGuard : Potassco::Theory_t::Atom);
+    append(atom.atom());
+    append(atom.occurrence());
+    append(atom.term());
+    append(atom.size());
+    for (auto &elemId : atom) { append(elemId); }
+    if (atom.guard()) {
+        append(*atom.guard());
+        append(*atom.rhs());
+    }
+    buf_.push_back('\n');
+    if (buf_.size() >= 1 << 16) { flush(); }
 }
 
 IntermediateFormatBackend::~IntermediateFormatBackend() noexcept = default;
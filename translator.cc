@@ -17,10 +17,12 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 #include "translator.hh"
+#include "eager.hh"
 #include <potassco/theory_data.h>
 #include <gringo/output/literals.hh>
 #include <ostream>
 #include <iostream>
+#include <sstream>
 #include <cstring>
 
 #define ASSIGN "assign"
@@ -31,158 +33,39 @@ namespace {
 
 // {{{1 Printing
 
-template <class T>
-struct PrintWrapper {
-    PrintWrapper(T const &value, Atom_t &atoms)
-    : value(value), atoms(atoms) { }
-    T const &value;
-    Atom_t &atoms;
-};
-
-template <class T>
-PrintWrapper<T> p(T const &value, Atom_t &atoms) {
-    return {value, atoms};
-}
-
-std::ostream &operator<<(std::ostream &out, PrintWrapper<LitSpan> const &p) {
-    out << p.value.size;
-    for (auto &&x : p.value) {
-        assert(x != 0);
-        out << " " << x;
-        p.atoms = std::max<Atom_t>(p.atoms, std::abs(x) + 1);
-    }
-    return out;
-}
-
-std::ostream &operator<<(std::ostream &out, PrintWrapper<AtomSpan> const &p) {
-    out << p.value.size;
-    for (auto &&x : p.value) {
-        assert(x != 0);
-        out << " " << x;
-        p.atoms = std::max(p.atoms, x + 1);
+void printJSON(std::ostream &out, std::string const &str) {
+    out << '"';
+    for (auto &&c : str) {
+        switch (c) {
+            case '"':  { out << "\\\""; break; }
+            case '\\': { out << "\\\\"; break; }
+            case '\n': { out << "\\n"; break; }
+            case '\t': { out << "\\t"; break; }
+            default:   { out << c; break; }
+        }
     }
-    return out;
+    out << '"';
 }
 
-std::ostream &operator<<(std::ostream &out, PrintWrapper<WeightLitSpan> const &p) {
-    out << p.value.size;
-    for (auto &&x : p.value) {
-        assert(x.lit != 0);
-        out << " " << x.lit << " " << x.weight;
-        p.atoms = std::max<Atom_t>(p.atoms, std::abs(x.lit) + 1);
+Gringo::Output::Backend::LitVec getCondition(Gringo::Output::TheoryData const &data, Id_t elemId) {
+    Gringo::Output::Backend::LitVec cond;
+    for (auto &&lit : data.getCondition(elemId)) {
+        cond.emplace_back(lit.sign() == Gringo::NAF::NOT ? -static_cast<Lit_t>(lit.offset()) : static_cast<Lit_t>(lit.offset()));
     }
-    return out;
+    return cond;
 }
 
-std::ostream &operator<<(std::ostream &out, PrintWrapper<HeadView> const &p) {
-    return out << p.value.type << " " << ::p(p.value.atoms, p.atoms);
-}
+// {{{1 Helpers
 
-std::ostream &operator<<(std::ostream &out, PrintWrapper<BodyView> const &p) {
-    out << p.value.type;
-    if (p.value.type != Body_t::Normal) { out << " " << p.value.bound; }
-    out << " " << p.value.lits.size;
-    for (auto &&x : p.value.lits) {
-        assert(x.lit != 0);
-        out << " " << x.lit;
-        p.atoms = std::max<Atom_t>(p.atoms, std::abs(x.lit) + 1);
-        if (p.value.type == Body_t::Sum) {
-            out << " " << x.weight;
-        }
-    }
-    return out;
+// Adds x to acc unless this overflows.
+bool addChecked(int64_t &acc, int64_t x) {
+    if (x > 0 ? acc > std::numeric_limits<int64_t>::max() - x : acc < std::numeric_limits<int64_t>::min() - x) { return false; }
+    acc += x;
+    return true;
 }
 
-class TheoryPrinter {
-public:
-    TheoryPrinter(Gringo::Output::TheoryData const &data, std::ostream &out)
-    : data_(data)
-    , out_(out) { }
-
-    void printTerm(Potassco::Id_t termId) {
-        if (seenTerms_.size() <= termId) { seenTerms_.resize(termId + 1, false); }
-        if (!seenTerms_[termId]) {
-            seenTerms_[termId] = true;
-            auto &term = data_.data().getTerm(termId);
-            switch (term.type()) {
-                case Potassco::Theory_t::Number: {
-                    out_ << Potassco::Directive_t::Theory << " " << Potassco::Theory_t::Number << " " << termId << " " << term.number() << "\n";
-                    break;
-                }
-                case Potassco::Theory_t::Symbol: {
-                    out_ << Potassco::Directive_t::Theory<< " " << Potassco::Theory_t::Symbol << " " << termId << " " << std::strlen(term.symbol()) << " " << term.symbol() << "\n";
-                    break;
-                }
-                case Potassco::Theory_t::Compound: {
-                    for (auto &termId : term) { printTerm(termId); }
-                    if (term.isFunction()) { printTerm(term.function()); }
-                    out_ << Potassco::Directive_t::Theory << " " << Potassco::Theory_t::Compound << " " << termId << " " << term.compound() << " " << term.size();
-                    for (auto &termId : term) { out_ << " " << termId; }
-                    out_ << "\n";
-                    break;
-                }
-            }
-        }
-    }
-
-    void debugTheoryAtom(std::ostream &out, Potassco::TheoryAtom const &atom) {
-        out << "% &";
-        data_.printTerm(out, atom.term());
-        out << "{";
-        bool comma = false;
-        for (auto &elemId : atom) {
-            if (comma) { out << "; ";}
-            else { comma = true; }
-            data_.printElem(out, elemId, [](std::ostream &out, Gringo::Output::LiteralId lit){ out << lit.offset(); });
-        }
-        out << "}";
-        if (atom.guard()) {
-            out << " ";
-            data_.printTerm(out, *atom.guard());
-            out << " ";
-            data_.printTerm(out, *atom.rhs());
-        }
-        out << " <=> " << atom.atom() << std::endl;
-    }
-    void debugTheoryTerm(std::ostream &out, Id_t term) {
-        data_.printTerm(out, term);
-    }
-    void printTheoryAtom(Potassco::TheoryAtom const &atom) {
-        //debugTheoryAtom(std::cerr, atom);
-        printTerm(atom.term());
-        for (auto &elemId : atom) {
-            if (seenElems_.size() <= elemId) { seenElems_.resize(elemId + 1, false); }
-            if (!seenElems_[elemId]) {
-                seenElems_[elemId] = true;
-                auto &elem = data_.data().getElement(elemId);
-                for (auto &termId : elem) { printTerm(termId); }
-                std::vector<Lit_t> cond;
-                for (auto &&lit : data_.getCondition(elemId)) { cond.emplace_back(lit.offset()); }
-                out_ << Potassco::Directive_t::Theory << " " << Potassco::Theory_t::Element << " " << elemId << " " << elem.size();
-                for (auto &termId : elem) { out_ << " " << termId; }
-                out_ << " " << cond.size();
-                for (auto &lit : cond) { out_ << " " << lit; }
-                out_ << "\n";
-            }
-        }
-        if (atom.guard()) {
-            printTerm(*atom.rhs());
-            printTerm(*atom.guard());
-        }
-        out_ << Potassco::Directive_t::Theory << " " << (atom.guard() ? Potassco::Theory_t::AtomWithGuard : Potassco::Theory_t::Atom) << " " << atom.atom() << " " << atom.occurrence() << " " << atom.term() << " " << atom.size();
-        for (auto &elemId : atom) { out_ << " " << elemId; }
-        if (atom.guard()) { out_ << " " << *atom.guard() << " " << *atom.rhs(); }
-        out_ << "\n";
-    }
-
-private:
-    Gringo::Output::TheoryData const &data_;
-    std::ostream &out_;
-    std::vector<bool> seenTerms_;
-    std::vector<bool> seenElems_;
-};
-
-// {{{1 Helpers
+// Note: the order has to match FoundedOutput::Symbol
+char const *keywords[] = { ASSIGN, "show", "sum", "distinct", "minimize", "+", "-", "*", "..", ":=", "/", "@" };
 
 template <class C, class F>
 void groupBy(C &c, F f) {
@@ -345,6 +228,11 @@ struct FoundedOutput::Disjunction {
 
 struct FoundedOutput::Define {
     virtual void encode(Gringo::Output::TheoryData &data, FoundedOutput &out, Id_t var, Variable &variable, Atom_t c) = 0;
+    // an upper bound on the number of values the range can assign
+    virtual uint64_t size(FoundedOutput const &out, Id_t var) const = 0;
+    // whether the range is known to contain the given value
+    virtual bool contains(int value) const = 0;
+    virtual char const *name() const = 0;
 };
 
 // {{{1 FoundedOutput::SimpleDefine
@@ -371,15 +259,24 @@ struct FoundedOutput::SimpleDefine : FoundedOutput::Define {
         Atom_t r = out.addSum(data, var, "<=", data.addTerm(right));
         WeightLit_t body[3] = {{lit(c), 1}, {-lit(l), 1}, {-lit(r), 1}};
         if (!variable.defined) {
-            out.rule({Head_t::Disjunctive, {&variable.atom, 1}}, {Body_t::Normal, 1, {body, 1}});
+            out.printRule({Head_t::Disjunctive, {&variable.atom, 1}}, {Body_t::Normal, 1, {body, 1}});
         }
-        out.rule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {body, 2}});
+        out.printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {body, 2}});
         std::swap(body[1], body[2]);
-        out.rule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {body, 2}});
+        out.printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {body, 2}});
         body[0] = {lit(variable.atom), 1};
         body[1].lit*= -1;
         body[2].lit*= -1;
-        out.rule({Head_t::Disjunctive, {&c, 1}}, {Body_t::Normal, 1, {!variable.defined ? body : body + 1, size_t(!variable.defined ? 3 : 2)}});
+        out.printRule({Head_t::Disjunctive, {&c, 1}}, {Body_t::Normal, 1, {!variable.defined ? body : body + 1, size_t(!variable.defined ? 3 : 2)}});
+    }
+    uint64_t size(FoundedOutput const &, Id_t) const override {
+        return left <= right ? int64_t(right) - left + 1 : 0;
+    }
+    bool contains(int value) const override {
+        return left <= value && value <= right;
+    }
+    char const *name() const override {
+        return "simple";
     }
     int left;
     int right;
@@ -398,13 +295,13 @@ struct FoundedOutput::GeneralDefine : FoundedOutput::Define {
         for (auto &&a : head) { h[i++] = a; }
         i = 0;
         for (auto &&l : body) { b[i++] = {l, 1}; }
-        out.rule({Head_t::Disjunctive, {h, head.size()}}, {Body_t::Normal, 1, {b, body.size()}});
+        out.printRule({Head_t::Disjunctive, {h, head.size()}}, {Body_t::Normal, 1, {b, body.size()}});
     }
     void rule(FoundedOutput &out, std::initializer_list<Atom_t> head, std::vector<WeightLit_t> const &body) {
         Atom_t h[head.size()];
         int i = 0;
         for (auto &&a : head) { h[i++] = a; }
-        out.rule({Head_t::Disjunctive, {h, head.size()}}, {Body_t::Normal, 1, toSpan(body)});
+        out.printRule({Head_t::Disjunctive, {h, head.size()}}, {Body_t::Normal, 1, toSpan(body)});
     }
     void encode(Gringo::Output::TheoryData &data, FoundedOutput &out, Id_t var, Variable &variable, Atom_t c) override {
         // c <=> ~~a & (a => v & d)
@@ -444,20 +341,29 @@ struct FoundedOutput::GeneralDefine : FoundedOutput::Define {
         VariableSet vars;
         left.collect(vars);
         right.collect(vars);
-        Atom_t na = out.atoms_++;
-        std::vector<Atom_t> a;
+        std::vector<Atom_t> a, open;
         for (auto &v : vars) {
             auto &&var = out.mapVar(v);
             if (!var.defined) {
                 a.emplace_back(var.atom);
-                rule(out, {na}, {-lit(var.atom)});
+                if (out.isNew(var)) { open.emplace_back(var.atom); }
+            }
+        }
+        // Note: the auxiliary atom only depends on the set of undefined variables
+        //       and is shared among all definitions with the same set
+        auto &&ret = out.undefinedAux_.emplace(a, 0);
+        if (ret.second) {
+            ret.first->second = out.newAtom("undefined");
+            for (auto &&l : a) {
+                rule(out, {ret.first->second}, {-lit(l)});
             }
         }
+        Atom_t na = ret.first->second;
         // :- c, ~a.
         rule(out, {}, {lit(c), lit(na)});
         // :- c,  a, ~d.
-        Atom_t l = out.addSum(data, left, "<=", var);
-        Atom_t r = out.addSum(data, right, ">=", var);
+        Atom_t l = out.addSum(data, left, "<=", out.rewriteTerm(data, var));
+        Atom_t r = out.addSum(data, right, ">=", out.rewriteTerm(data, var));
         std::vector<WeightLit_t> body;
         body.push_back({lit(c), 1});
         for (auto &&l : a) {
@@ -484,99 +390,265 @@ struct FoundedOutput::GeneralDefine : FoundedOutput::Define {
         // a | c :- ~~v, d, ~~a.
         body.clear();
         if (!variable.defined) {
-            Atom_t nv = out.atoms_++;
-            rule(out, {nv}, {-lit(variable.atom)});
-            body.push_back({-lit(nv), 1});
+            auto &&ret = out.undefinedVarAux_.emplace(var, 0);
+            if (ret.second) {
+                ret.first->second = out.newAtom("undefined-variable", var);
+                rule(out, {ret.first->second}, {-lit(variable.atom)});
+            }
+            body.push_back({-lit(ret.first->second), 1});
         }
         body.push_back({lit(l), 1});
         body.push_back({lit(r), 1});
         body.push_back({-lit(na), 1});
-        for (auto &&l : a) {
+        // Note: atoms of variables from earlier steps cannot be redefined
+        for (auto &&l : open) {
             rule(out, {l, c}, body);
         }
     }
+    uint64_t size(FoundedOutput const &out, Id_t var) const override {
+        // Note: the bounds are used as the values depend on other variables
+        auto b = out.bound(var);
+        return int64_t(b.second) - b.first + 1;
+    }
+    bool contains(int) const override {
+        return false;
+    }
+    char const *name() const override {
+        return "general";
+    }
     LinearTerm const &left;
     LinearTerm const &right;
 };
 
 // {{{1 FoundedOutput
 
-FoundedOutput::FoundedOutput(std::ostream& out, ConditionVec &conditions, TheoryData &data, int min, int max)
+FoundedOutput::FoundedOutput(Gringo::Output::Backend &out, TheoryData &outData, ConditionVec &conditions, TheoryData &data, int min, int max)
 : out_(out)
+, outData_(outData)
+, outTheory_(outData)
 , data_(data)
 , conditions_(conditions)
-, atoms_(0)
+, atoms_(1)
 , min_(min)
-, max_(max) { }
+, max_(max) {
+    for (auto &keyword : keywords) { intern(keyword); }
+    assert(symbols_.size() == static_cast<unsigned>(Symbol::Other));
+}
 FoundedOutput::~FoundedOutput() noexcept = default;
 
+void FoundedOutput::addBound(std::string const &name, int arity, int min, int max) {
+    signatureBounds_[Signature(intern(name.c_str()), arity)] = {min, max};
+}
+
+void FoundedOutput::addBound(std::string const &term, int min, int max) {
+    termBounds_[term] = {min, max};
+}
+
+void FoundedOutput::enableSymmetryBreaking(bool enable) {
+    breakSymmetries_ = enable;
+}
+
+void FoundedOutput::enableEager(unsigned limit) {
+    eager_ = limit;
+}
+
+void FoundedOutput::enableObjectiveBounds(bool enable) {
+    objectiveBounds_ = enable;
+}
+
+void FoundedOutput::enableUnusedElimination(bool enable) {
+    dropUnused_ = enable;
+}
+
+void FoundedOutput::enableHeuristic(Heuristic heuristic) {
+    heuristic_ = heuristic;
+}
+
+void FoundedOutput::enableProvenance(std::ostream *out) {
+    provenance_ = out;
+}
+
+void FoundedOutput::enableProjection(unsigned limit) {
+    project_ = limit;
+}
+
+void FoundedOutput::enableWarmStart(bool enable) {
+    warmStart_ = enable;
+}
+
+void FoundedOutput::addInitialValue(std::string const &term, int value) {
+    initialValues_[term] = value;
+}
+
+void FoundedOutput::addInitialAtom(std::string const &atom) {
+    initialAtoms_.emplace(atom);
+}
+
 void FoundedOutput::initProgram(bool incremental) {
-    if (incremental) { throw std::runtime_error("incremental programs are not supported at the moment"); }
-    out_ << "asp 1 0 0" << (incremental ? " incremental" : "") << "\n";
+    require(!incremental || !breakSymmetries_, "symmetry breaking is not supported for incremental programs");
+    require(!incremental || !eager_, "eager encoding is not supported for incremental programs");
+    require(!incremental || !objectiveBounds_, "objective bounds are not supported for incremental programs");
+    require(!incremental || !dropUnused_, "dropping unused variables is not supported for incremental programs");
+    require(!incremental || !project_, "projection is not supported for incremental programs");
+    incremental_ = incremental;
+    out_.init(incremental);
 }
 
 void FoundedOutput::beginStep() {
+    out_.beginStep();
+}
+
+Atom_t FoundedOutput::mapAtom(Atom_t atom) {
+    assert(atom != 0);
+    if (!incremental_) {
+        atoms_ = std::max(atoms_, atom + 1);
+        return atom;
+    }
+    // Note: atoms of later steps are not known in advance,
+    //       so input atoms share one numbering with auxiliary atoms
+    if (inputAtoms_.size() <= atom) { inputAtoms_.resize(atom + 1, 0); }
+    auto &ret = inputAtoms_[atom];
+    if (!ret) { ret = newAtom("input"); }
+    return ret;
+}
+
+Lit_t FoundedOutput::mapLit(Lit_t lit) {
+    Lit_t ret = static_cast<Lit_t>(mapAtom(Potassco::atom(lit)));
+    return lit < 0 ? -ret : ret;
+}
+
+Gringo::Output::Backend::AtomVec &FoundedOutput::toAtoms(AtomSpan const &atoms) {
+    auto &ret = out_.tempAtoms();
+    for (auto &&x : atoms) { ret.emplace_back(mapAtom(x)); }
+    return ret;
+}
+
+Gringo::Output::Backend::LitVec &FoundedOutput::toLits(LitSpan const &lits) {
+    auto &ret = out_.tempLits();
+    for (auto &&x : lits) { ret.emplace_back(mapLit(x)); }
+    return ret;
+}
+
+Gringo::Output::Backend::LitWeightVec &FoundedOutput::toWLits(WeightLitSpan const &lits) {
+    auto &ret = out_.tempWLits();
+    for (auto &&x : lits) { ret.push_back({mapLit(x.lit), x.weight}); }
+    return ret;
 }
 
 void FoundedOutput::rule(const HeadView& head, const BodyView& body) {
+    headBuf_.clear();
+    for (auto &&x : head.atoms) { headBuf_.emplace_back(mapAtom(x)); }
+    bodyBuf_.clear();
+    for (auto &&x : body.lits) { bodyBuf_.push_back({mapLit(x.lit), x.weight}); }
     if (head.type == Head_t::Disjunctive && head.atoms.size == 1 && body.type == Body_t::Normal && body.lits.size == 0) {
-        facts_.emplace(*head.atoms.first);
+        facts_.emplace(headBuf_.front());
+    }
+    printRule({head.type, toSpan(headBuf_)}, {body.type, body.bound, toSpan(bodyBuf_)});
+}
+
+void FoundedOutput::printRule(const HeadView& head, const BodyView& body) {
+    auto &atoms = out_.tempAtoms();
+    atoms.assign(begin(head.atoms), end(head.atoms));
+    out_.printHead(head.type == Head_t::Choice, atoms);
+    switch (body.type) {
+        case Body_t::Normal: {
+            auto &lits = out_.tempLits();
+            for (auto &&x : body.lits) { lits.emplace_back(x.lit); }
+            out_.printNormalBody(lits);
+            break;
+        }
+        case Body_t::Count: {
+            // count bodies are passed as sum bodies with unit weights
+            auto &lits = out_.tempWLits();
+            for (auto &&x : body.lits) { lits.push_back({x.lit, 1}); }
+            out_.printWeightBody(body.bound, lits);
+            break;
+        }
+        case Body_t::Sum: {
+            auto &lits = out_.tempWLits();
+            lits.assign(begin(body.lits), end(body.lits));
+            out_.printWeightBody(body.bound, lits);
+            break;
+        }
     }
-    out_ << Directive_t::Rule << " " << p(head, atoms_) << " " << p(body, atoms_) << "\n";
 }
 
 void FoundedOutput::minimize(Weight_t prio, const WeightLitSpan& lits) {
-    out_ << Directive_t::Minimize << " " << prio << " " << p(lits, atoms_) << "\n";
+    out_.printMinimize(prio, toWLits(lits));
 }
 
 void FoundedOutput::output(const StringSpan& str, const LitSpan& cond) {
-    out_ << Directive_t::Output << " " << str.size << " ";
-    out_.write(str.first, str.size) << " " << p(cond, atoms_) << "\n";
+    std::string name(str.first, str.size);
+    if (warmStart_ && cond.size == 1 && *cond.first > 0) {
+        // #heuristic a. [1, sign] or #heuristic a. [-1, sign]
+        int sign = initialAtoms_.find(name) != initialAtoms_.end() ? 1 : -1;
+        out_.printHeuristic(Heuristic_t::Sign, mapAtom(*cond.first), sign, 0, toLits({nullptr, 0}));
+    }
+    if (project_) {
+        for (auto &&l : cond) { projectAtoms_.emplace_back(mapAtom(Potassco::atom(l))); }
+    }
+    out_.printOutput(name.c_str(), toLits(cond));
 }
 
 void FoundedOutput::assume(const LitSpan& lits) {
-    out_ << Directive_t::Assume << " " << p(lits, atoms_) << "\n";
+    out_.printAssume(toLits(lits));
 }
 
 void FoundedOutput::external(Atom_t a, Value_t v) {
-    atoms_ = std::max(atoms_, a + 1);
-    out_ << Directive_t::External << " " << a << " " << v << "\n";
+    out_.printExternal(mapAtom(a), v);
 }
 
 void FoundedOutput::project(const AtomSpan& atoms) {
-    out_ << Directive_t::Project << " " << p(atoms, atoms_) << "\n";
+    out_.printProject(toAtoms(atoms));
 }
 
 void FoundedOutput::acycEdge(int s, int t, const LitSpan& condition) {
-    out_ << Directive_t::Edge << " " << s << " " << t << " " << p(condition, atoms_) << "\n";
+    out_.printEdge(s, t, toLits(condition));
 }
 
 void FoundedOutput::heuristic(Atom_t a, Heuristic_t t, int bias, unsigned prio, const LitSpan& condition) {
-    atoms_ = std::max(atoms_, a + 1);
-    out_ << Directive_t::Heuristic << " " << t << " " << a << " " << bias << " " << prio << " " << p(condition, atoms_) << "\n";
+    out_.printHeuristic(t, mapAtom(a), bias, prio, toLits(condition));
 }
 
 void FoundedOutput::require(bool exp, char const *message) const {
     if (!exp) { throw std::runtime_error(message); }
 }
 
-// Note: for now theory elements with conditions are not supported
-//       because we do not have a semantics for such language constructs yet
+// Note: conditions are only supported for elements of sum and distinct
+//       constraints, for the remaining atoms we do not have a semantics yet
 TheoryElement const &FoundedOutput::requireEmptyCondition(Id_t elemId) const {
     auto &&elem = data_.getElement(elemId);
     require(elem.condition() == 0, "non empty conditions are not supported");
     return elem;
 }
 
-bool FoundedOutput::isOp(char const *op) const {
-    // is there an algorithm for this???
-    return strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || strcmp(op, "*") == 0;
+unsigned FoundedOutput::intern(char const *name) const {
+    return symbols_.emplace(name, symbols_.size()).first->second;
+}
+
+unsigned FoundedOutput::intern(Id_t termId) const {
+    if (termSymbols_.size() <= termId) { termSymbols_.resize(termId + 1, std::numeric_limits<unsigned>::max()); }
+    auto &sym = termSymbols_[termId];
+    if (sym == std::numeric_limits<unsigned>::max()) { sym = intern(data_.getTerm(termId).symbol()); }
+    return sym;
+}
+
+FoundedOutput::Symbol FoundedOutput::symbol(Id_t termId) const {
+    return static_cast<Symbol>(std::min(intern(termId), static_cast<unsigned>(Symbol::Other)));
+}
+
+FoundedOutput::Symbol FoundedOutput::function(TheoryTerm const &term) const {
+    return term.isFunction() ? symbol(term.function()) : Symbol::Other;
+}
+
+bool FoundedOutput::isOp(Symbol sym) {
+    return sym == Symbol::Add || sym == Symbol::Sub || sym == Symbol::Mul;
 }
 
 Id_t FoundedOutput::requireNotOperator(Id_t termId) const {
     auto &&term = data_.getTerm(termId);
     if (term.type() == Theory_t::Compound) {
-        require(term.isFunction() && !isOp(data_.getTerm(term.function()).symbol()), "unexpected operator");
+        require(term.isFunction() && !isOp(function(term)), "unexpected operator");
         for (auto &&t : term) { requireNotOperator(t); }
         return termId;
     }
@@ -589,7 +661,7 @@ Id_t FoundedOutput::requireVariable(Id_t termId) const {
         case Theory_t::Number: { require(false, "variable expected"); }
         case Theory_t::Symbol: { break; }
         case Theory_t::Compound: {
-            require(term.isFunction() && !isOp(data_.getTerm(term.function()).symbol()), "variable expected");
+            require(term.isFunction() && !isOp(function(term)), "variable expected");
             for (auto &&t : term) { requireNotOperator(t); }
             return termId;
         }
@@ -601,13 +673,13 @@ Id_t FoundedOutput::requireWeight(Id_t termId) const {
     auto &&term = data_.getTerm(termId);
     if (term.type() == Theory_t::Compound) {
         require(term.isFunction(), "weight expected");
-        char const *name = data_.getTerm(term.function()).symbol();
+        auto sym = function(term);
         // for simplicity weights do not support +/2 and -/2
-        if (strcmp(name, "*") == 0 && term.size() == 2) {
+        if (sym == Symbol::Mul && term.size() == 2) {
             requireWeight(*term.begin());
             requireWeight(*(term.begin() + 1));
         }
-        else if (strcmp(name, "-") == 0 && strcmp(name, "+") == 0 && term.size() == 1) {
+        else if ((sym == Symbol::Sub || sym == Symbol::Add) && term.size() == 1) {
             requireWeight(*term.begin());
         }
         else {
@@ -621,8 +693,7 @@ void FoundedOutput::collectVariablesWeightPrio(VariableSet &vars, Id_t termId) c
     auto &&term = data_.getTerm(termId);
     if (term.type() == Theory_t::Compound) {
         require(term.isFunction(), "weight with optional priority expected");
-        char const *name = data_.getTerm(term.function()).symbol();
-        if (strcmp(name, "@") == 0 && term.size() == 2) {
+        if (function(term) == Symbol::At && term.size() == 2) {
             requireWeight(*term.begin());
             collectVariables(vars, *term.begin());
         }
@@ -645,7 +716,7 @@ void FoundedOutput::collectVariables(VariableSet &vars, Id_t termId) const {
             break;
         }
         case Theory_t::Compound: {
-            if (term.isFunction() && isOp(data_.getTerm(term.function()).symbol())) {
+            if (isOp(function(term))) {
                 for (auto &&t : term) {
                     collectVariables(vars, t);
                 }
@@ -660,9 +731,9 @@ void FoundedOutput::collectVariables(VariableSet &vars, Id_t termId) const {
 FoundedOutput::VariableSet FoundedOutput::collectVariables(Potassco::TheoryAtom const &atom) const {
     VariableSet vars;
     for (auto &&elemId : atom) {
-        auto &&elem = requireEmptyCondition(elemId);
+        auto &&elem = data_.getElement(elemId);
         require(elem.size() > 0, "not a valid constraint");
-        collectVariables(vars, *elem.begin());
+        if (!elem.condition()) { collectVariables(vars, *elem.begin()); }
     }
     if (atom.guard()) {
         collectVariables(vars, *atom.rhs());
@@ -670,47 +741,88 @@ FoundedOutput::VariableSet FoundedOutput::collectVariables(Potassco::TheoryAtom
     return vars;
 }
 
+bool FoundedOutput::collectUndefined(VariableSet const &vars, std::vector<WeightLit_t> &body) const {
+    bool mapped = true;
+    for (auto &&v : vars) {
+        auto it = varMap_.find(v);
+        if (it == varMap_.end()) {
+            // Note: in incremental programs such variables must not be assigned in later steps
+            mapped = false;
+            if (!incremental_) { break; }
+            referenced_.emplace(v);
+        }
+        else if (!it->second.defined) { body.push_back({lit(it->second.atom), 1}); }
+    }
+    return mapped;
+}
+
 FoundedOutput::Variable &FoundedOutput::mapVar(Id_t var) {
     // TODO: a variable should only receive an atom if necessary
     auto &&ret = varMap_.emplace(var, atoms_);
-    if (ret.second) { ++atoms_; }
+    if (ret.second) {
+        newAtom("variable", var);
+        stepVars_.emplace_back(var);
+    }
     return ret.first->second;
 }
 
+bool FoundedOutput::isNew(Variable const &var) const {
+    return var.atom >= stepBegin_;
+}
+
 void FoundedOutput::rewriteConstraint(Gringo::Output::TheoryData &data, TheoryAtom const &atom) {
     // Outline:
-    // - collect contained csp variables      { v1, ..., vn }
-    // - associate an atom with each variable { a1, ..., an }
+    // - collect csp variables of unconditional elements { v1, ..., vn }
+    // - associate an atom with each variable            { a1, ..., an }
+    // - for each element with condition C and variables { w1, ..., wm }
+    //   associated with atoms { b1, ..., bm }, introduce an atom e and
+    //   add rules: e :- not l. for each l in C
+    //              e :- b1, ..., bm.
     // - let a be the atom associated with the theory atom A
-    // - add rule: a :- A, a1, ..., an.
+    // - add rule: a :- A, a1, ..., an, e1, ..., ek.
     //   where A is associated with a fresh atom a'
+    // Note: the conditions are passed on to the solver unchanged
     require(atom.atom() > 0, "theory atoms must be associated with aspif atoms");
     VariableSet vars = collectVariables(atom);
     std::vector<WeightLit_t> body;
     body.reserve(vars.size() + 1);
-    for (auto &&v : vars) {
-        auto it = varMap_.find(v);
-        if (it == varMap_.end()) {
-            std::vector<Atom_t> head({atom.atom()});
-            body.clear();
-            body.push_back({lit(atom.atom()), 1});
-            rule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, toSpan(body)});
-            return;
+    if (!collectUndefined(vars, body)) {
+        body.clear();
+        body.push_back({lit(mapAtom(atom.atom())), 1});
+        printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, toSpan(body)});
+        return;
+    }
+    std::vector<WeightLit_t> elemBody;
+    for (auto &&elemId : atom) {
+        auto &&elem = data_.getElement(elemId);
+        if (!elem.condition()) { continue; }
+        VariableSet elemVars;
+        collectVariables(elemVars, *elem.begin());
+        for (auto &&v : vars) { elemVars.erase(v); }
+        elemBody.clear();
+        bool mapped = collectUndefined(elemVars, elemBody);
+        if (mapped && elemBody.empty()) { continue; }
+        Atom_t e = newAtom("condition");
+        for (auto &&l : conditions_[elem.condition() - 1]) {
+            WeightLit_t neg{-mapLit(l), 1};
+            printRule({Head_t::Disjunctive, {&e, 1}}, {Body_t::Normal, 1, {&neg, 1}});
+        }
+        if (mapped) {
+            printRule({Head_t::Disjunctive, {&e, 1}}, {Body_t::Normal, static_cast<Weight_t>(elemBody.size()), toSpan(elemBody)});
         }
-        if (!it->second.defined) { body.push_back({lit(it->second.atom), 1}); }
+        body.push_back({lit(e), 1});
     }
 
     body.push_back({lit(rewriteAtom(data, atom, true)), 1});
-    std::vector<Atom_t> head({atom.atom()});
-    rule({Head_t::Disjunctive, toSpan(head)}, {Body_t::Normal, static_cast<Weight_t>(body.size()), toSpan(body)});
+    std::vector<Atom_t> head({mapAtom(atom.atom())});
+    printRule({Head_t::Disjunctive, toSpan(head)}, {Body_t::Normal, static_cast<Weight_t>(body.size()), toSpan(body)});
 }
 
 Atom_t FoundedOutput::addSum(Gringo::Output::TheoryData &data, Id_t term, char const *rel, Id_t rhs) {
     Id_t t = rewriteTerm(data, term);
     Id_t elem = data.addElem({&t, 1}, {});
-    auto &&newAtom = [&]() { return atoms_++; };
     auto &&ret = data.addAtom(
-        newAtom,
+        [&]() { return newAtom("sum"); },
         TheoryAtom::Occurrence::occ_body,
         data.addTerm("sum"),
         {&elem, 1},
@@ -746,11 +858,11 @@ FoundedOutput::LinearTerm FoundedOutput::parseLinearTerm(Id_t ti) {
         case Theory_t::Symbol: { return {0, {{ti, 1}}}; }
         default: {
             if (tp.isFunction()) {
-                char const *name = data_.getTerm(tp.function()).symbol();
-                if (isOp(name)) {
+                auto sym = function(tp);
+                if (isOp(sym)) {
                     Op op = Op::Add;
-                    if (strcmp(name, "-") == 0) { op = Op::Sub; }
-                    if (strcmp(name, "*") == 0) { op = Op::Mul; }
+                    if (sym == Symbol::Sub) { op = Op::Sub; }
+                    if (sym == Symbol::Mul) { op = Op::Mul; }
                     if (tp.size() == 2) {
                         return combine(parseLinearTerm(*tp.begin()), parseLinearTerm(*(tp.begin() + 1)), op);
                     }
@@ -770,18 +882,16 @@ FoundedOutput::LinearTerm FoundedOutput::parseLinearTerm(Id_t ti) {
 
 void FoundedOutput::rewriteDom(TheoryAtom const &atom) {
     constexpr char const *message = "invalid " ASSIGN " atom";
-    Disjunction assign{atom.atom()};
+    Disjunction assign{mapAtom(atom.atom())};
     for (auto &&elemId : atom) {
         auto &&elem = requireEmptyCondition(elemId);
         require(elem.size() == 1, message);
         auto &&term = data_.getTerm(*elem.begin());
-        require(term.type() == Theory_t::Compound && term.size() == 2 && term.isFunction(), message);
-        auto &&name = data_.getTerm(term.function()).symbol();
-        require(strcmp(name, ":=") == 0, message);
+        require(term.type() == Theory_t::Compound && term.size() == 2 && function(term) == Symbol::Define, message);
         auto &&var = requireVariable(*term.begin());
         auto &&rng = data_.getTerm(*(term.begin() + 1));
         Id_t termLeft, termRight;
-        if (rng.type() == Theory_t::Compound && rng.size() == 2 && rng.isFunction() && strcmp(data_.getTerm(rng.function()).symbol(), "..") == 0) {
+        if (rng.type() == Theory_t::Compound && rng.size() == 2 && function(rng) == Symbol::Range) {
             termLeft = *rng.begin();
             termRight = *(rng.begin() + 1);
         }
@@ -814,9 +924,11 @@ void FoundedOutput::printAssign(Gringo::Output::TheoryData &data, Disjunction co
     //   afterward, uses strong-equivalence preserving rewritings to obtain a disjunctive logic program
     //   this translation introduces loops which very likely have a detrimental effect on the performance of constraint ASP solvers
     //   ideally, small disjunctions would simply be unfolded
+    setOrigin("assign", assign.atom);
     std::map<int, std::vector<std::unique_ptr<Define>>> domain;
     for (auto &&a : assign.elems) {
         auto &&dom = mapVar(a.var);
+        require(isNew(dom) && referenced_.find(a.var) == referenced_.end(), "variables must be assigned in the step they are first used in");
         if (a.left.constant() && a.right.constant()) {
             dom.extend(a.left.fixed, a.right.fixed);
             domain[a.var].emplace_back(new SimpleDefine(a.left.fixed, a.right.fixed));
@@ -831,13 +943,386 @@ void FoundedOutput::printAssign(Gringo::Output::TheoryData &data, Disjunction co
     for (auto &&ent : domain) {
         Variable &var = mapVar(ent.first);
         for (auto &&rng : ent.second) {
-            Atom_t c = atoms_++;
+            setOrigin("assign", assign.atom, ent.first, rng->name());
+            Atom_t c = newAtom("range");
             head.emplace_back(c);
+            if (heuristic_ != Heuristic::None) { choices_.emplace_back(rng->size(*this, ent.first), c); }
+            int value;
+            if (warmStart_ && initialValue(ent.first, value) && rng->contains(value)) {
+                // #heuristic c. [1, sign]
+                out_.printHeuristic(Heuristic_t::Sign, c, 1, 0, toLits({nullptr, 0}));
+            }
             rng->encode(data, *this, ent.first, var, c);
         }
     }
     // c1, ..., cn :- a.
-    rule({Head_t::Disjunctive, toSpan(head)}, {Body_t::Normal, 1, {&body, 1}});
+    printRule({Head_t::Disjunctive, toSpan(head)}, {Body_t::Normal, 1, {&body, 1}});
+}
+
+void FoundedOutput::dropUnused() {
+    // Outline:
+    // - a variable is observed if it is shown, occurs in a theory atom other than an assignment,
+    //   or occurs in an assignment that is kept (including the bounds of its ranges)
+    // - an assignment is dropped if it assigns only unobserved variables,
+    //   one of its elements assigns a non-empty constant range,
+    //   and its variables are not constrained by other assignments,
+    //   i.e., dropping it neither hides a value nor removes a failing assignment
+    // - a variable assigned by several assignments is only unconstrained
+    //   if all of them are facts assigning one constant range
+    //   and the ranges have a common value within the bound of the variable
+    // - this is iterated until a fixpoint is reached
+    //   because keeping an assignment might make further variables observed
+    if (showTable_.empty()) { return; }
+    VariableSet observed;
+    std::function<void (Id_t)> observe = [&](Id_t termId) {
+        auto &&term = data_.getTerm(termId);
+        observed.emplace(termId);
+        if (term.type() == Theory_t::Compound) {
+            for (auto &&t : term) { observe(t); }
+        }
+    };
+    for (auto it = data_.currBegin(), ie = data_.end(); it != ie; ++it) {
+        auto &&atom = *it;
+        auto &&term = data_.getTerm(atom->term());
+        Symbol sym = term.type() == Theory_t::Symbol ? symbol(atom->term()) : Symbol::Other;
+        if (sym == Symbol::Assign || sym == Symbol::Show) { continue; }
+        for (auto &&elemId : *atom) {
+            for (auto &&t : data_.getElement(elemId)) { observe(t); }
+        }
+        if (atom->guard()) { observe(*atom->rhs()); }
+    }
+    for (auto &&assign : assign_) {
+        for (auto &&elem : assign.elems) {
+            if (showTable_.find(signature(elem.var)) != showTable_.end()) { observed.emplace(elem.var); }
+        }
+    }
+    auto satisfiable = [this](Assignment const &elem) {
+        if (!elem.left.constant() || !elem.right.constant()) { return false; }
+        Bound b = bound(elem.var);
+        return std::max(b.first, elem.left.fixed) <= std::min(b.second, elem.right.fixed);
+    };
+    std::map<Id_t, std::vector<size_t>> occurrences;
+    for (size_t i = 0; i < assign_.size(); ++i) {
+        for (auto &&elem : assign_[i].elems) {
+            auto &&occ = occurrences[elem.var];
+            if (occ.empty() || occ.back() != i) { occ.emplace_back(i); }
+        }
+    }
+    auto unconstrained = [&](Id_t var) {
+        auto &&occ = occurrences[var];
+        if (occ.size() == 1) { return true; }
+        Bound b = bound(var);
+        for (auto &&i : occ) {
+            auto &&assign = assign_[i];
+            if (facts_.find(assign.atom) == facts_.end() || assign.elems.size() != 1) { return false; }
+            auto &&elem = assign.elems.front();
+            if (!elem.left.constant() || !elem.right.constant()) { return false; }
+            b.first = std::max(b.first, elem.left.fixed);
+            b.second = std::min(b.second, elem.right.fixed);
+        }
+        return b.first <= b.second;
+    };
+    std::vector<bool> keep(assign_.size(), false);
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t i = 0; i < assign_.size(); ++i) {
+            auto &&elems = assign_[i].elems;
+            if (keep[i]) { continue; }
+            if (std::none_of(elems.begin(), elems.end(), [&](Assignment const &elem) { return observed.count(elem.var) > 0; }) &&
+                std::any_of(elems.begin(), elems.end(), satisfiable) &&
+                std::all_of(elems.begin(), elems.end(), [&](Assignment const &elem) { return unconstrained(elem.var); })) { continue; }
+            keep[i] = true;
+            changed = true;
+            for (auto &&elem : elems) {
+                observed.emplace(elem.var);
+                elem.left.collect(observed);
+                elem.right.collect(observed);
+            }
+        }
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < assign_.size(); ++i) {
+        if (keep[i]) {
+            if (i != j) { assign_[j] = std::move(assign_[i]); }
+            ++j;
+        }
+    }
+    assign_.erase(assign_.begin() + j, assign_.end());
+}
+
+void FoundedOutput::printHeuristics() {
+    // Note: the translation only needs the choices for assignment ranges and
+    //       the atoms of variables to be decided, all other atoms it introduces follow by propagation
+    // #heuristic v. [1, sign]
+    for (auto &&varId : stepVars_) {
+        auto &&var = varMap_.find(varId)->second;
+        if (!var.defined) { out_.printHeuristic(Heuristic_t::Sign, var.atom, 1, 0, toLits({nullptr, 0})); }
+    }
+    // #heuristic c. [1, sign]
+    // #heuristic c. [k, level] or #heuristic c. [k + 1, factor]
+    //   where ranges with the smallest domain are ranked highest
+    std::vector<uint64_t> sizes;
+    for (auto &&choice : choices_) { sizes.emplace_back(choice.first); }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    for (auto &&choice : choices_) {
+        out_.printHeuristic(Heuristic_t::Sign, choice.second, 1, 0, toLits({nullptr, 0}));
+        int rank = sizes.end() - std::lower_bound(sizes.begin(), sizes.end(), choice.first);
+        switch (heuristic_) {
+            case Heuristic::Level:  { out_.printHeuristic(Heuristic_t::Level, choice.second, rank, 0, toLits({nullptr, 0})); break; }
+            case Heuristic::Factor: { out_.printHeuristic(Heuristic_t::Factor, choice.second, rank + 1, 0, toLits({nullptr, 0})); break; }
+            default:                { break; }
+        }
+    }
+    choices_.clear();
+}
+
+void FoundedOutput::setOrigin(char const *name, Atom_t source, Id_t var, char const *define) {
+    origin_.name = name;
+    origin_.source = source;
+    origin_.var = var;
+    origin_.define = define;
+}
+
+void FoundedOutput::setOrigin(TheoryAtom const &atom) {
+    auto &&term = data_.getTerm(atom.term());
+    setOrigin(term.type() == Theory_t::Symbol ? term.symbol() : "theory", atom.atom() ? mapAtom(atom.atom()) : 0);
+}
+
+Atom_t FoundedOutput::newAtom(char const *kind, Id_t var) {
+    Atom_t atom = atoms_++;
+    if (provenance_) { printProvenance(atom, kind, var); }
+    return atom;
+}
+
+void FoundedOutput::printProvenance(Atom_t atom, char const *kind, Id_t var) {
+    // {"atom":a,"kind":k,"origin":o,"source":s,"var":v,"define":d}
+    //   where all but atom and kind are optional
+    auto &out = *provenance_;
+    out << "{\"atom\":" << atom << ",\"kind\":\"" << kind << "\"";
+    if (origin_.name) {
+        out << ",\"origin\":";
+        printJSON(out, origin_.name);
+    }
+    if (origin_.source) { out << ",\"source\":" << origin_.source; }
+    if (var == noVar) { var = origin_.var; }
+    if (var != noVar) {
+        std::ostringstream oss;
+        printVariable(oss, var);
+        out << ",\"var\":";
+        printJSON(out, oss.str());
+    }
+    if (origin_.define) { out << ",\"define\":\"" << origin_.define << "\""; }
+    out << "}\n";
+}
+
+void FoundedOutput::printProjection(Gringo::Output::TheoryData &data, std::vector<Id_t> const &shown) {
+    // Note: clingcon cannot project onto variables,
+    //       so each value of a shown variable is represented by an equality
+    //       that is not used anywhere and thus does not restrict the solutions
+    // #project { a : a is shown } + { v : v is a shown variable } + { s : s is &sum { v } = value }.
+    auto &atoms = out_.tempAtoms();
+    atoms.insert(atoms.end(), projectAtoms_.begin(), projectAtoms_.end());
+    for (auto &&varId : shown) {
+        auto &&var = varMap_.find(varId)->second;
+        setOrigin("projection", 0, varId);
+        if (!var.defined) { atoms.emplace_back(var.atom); }
+        Bound b = bound(varId);
+        Variable::Domain dom;
+        if (var.bounded()) { dom = var.domain; }
+        else if (var.bounded(b.first, b.second)) { dom.emplace_back(b); }
+        // Note: variables without a finite domain exceed every limit
+        int64_t size = dom.empty() ? std::numeric_limits<int64_t>::max() : 0;
+        for (auto &&d : dom) { size+= std::max<int64_t>(0, int64_t(std::min(b.second, d.second)) - std::max(b.first, d.first) + 1); }
+        if (size > project_) {
+            std::ostringstream msg;
+            msg << "projection requires at most " << project_ << " values for shown variable ";
+            printVariable(msg, varId);
+            msg << "; use --bounds or raise the limit";
+            throw std::runtime_error(msg.str());
+        }
+        for (auto &&d : dom) {
+            for (int64_t value = std::max(b.first, d.first), last = std::min(b.second, d.second); value <= last; ++value) {
+                atoms.emplace_back(addSum(data, varId, "=", data.addTerm(static_cast<int>(value))));
+            }
+        }
+    }
+    out_.printProject(atoms);
+    projectAtoms_.clear();
+}
+
+bool FoundedOutput::initialValue(Id_t varId, int &value) const {
+    if (initialValues_.empty()) { return false; }
+    std::ostringstream oss;
+    printVariable(oss, varId);
+    auto it = initialValues_.find(oss.str());
+    if (it == initialValues_.end()) { return false; }
+    value = it->second;
+    return true;
+}
+
+void FoundedOutput::warmStart(Gringo::Output::TheoryData &data) {
+    // Note: the solver is steered towards the previous values by preferring
+    //       the atoms of assigned variables and an equality to the previous value;
+    //       the equality is not used anywhere and thus does not restrict the solutions
+    for (auto &&varId : stepVars_) {
+        int value;
+        if (!initialValue(varId, value)) { continue; }
+        auto &&var = varMap_.find(varId)->second;
+        setOrigin("warm-start", 0, varId);
+        // #heuristic v. [1, sign]
+        if (!var.defined) { out_.printHeuristic(Heuristic_t::Sign, var.atom, 1, 0, toLits({nullptr, 0})); }
+        // #heuristic s. [1, sign]
+        // #heuristic s. [1, init]
+        //   where s is &sum { v } = value
+        Atom_t s = addSum(data, varId, "=", data.addTerm(value));
+        out_.printHeuristic(Heuristic_t::Sign, s, 1, 0, toLits({nullptr, 0}));
+        out_.printHeuristic(Heuristic_t::Init, s, 1, 0, toLits({nullptr, 0}));
+    }
+}
+
+void FoundedOutput::breakSymmetries(Gringo::Output::TheoryData &data) {
+    // Outline:
+    // - candidates are variables that are only defined by facts assigning constant ranges
+    // - the signature of a candidate consists of its domain intersected with its bound
+    //   and its occurrences in constraints
+    //   where an occurrence is a constraint together with the coefficient of the variable
+    //   (and the constant of the element for distinct constraints or the priority for minimize constraints)
+    // - swapping two variables with the same signature maps the program onto itself
+    //   so the values of a group of such variables v1, ..., vn can be ordered:
+    //   :- not &sum { vi } <= vi+1.
+    using Occurrence = std::tuple<unsigned, int, int>;
+    struct Candidate {
+        std::vector<Variable::Domain> domains;
+        std::vector<Occurrence> occurrences;
+        bool excluded = false;
+    };
+    std::map<Id_t, Candidate> candidates;
+    auto exclude = [&](VariableSet const &vars) {
+        for (auto &&v : vars) { candidates[v].excluded = true; }
+    };
+    for (auto &&assign : assign_) {
+        Id_t var;
+        bool simple = assign.defines(*this, var);
+        Variable::Domain dom;
+        for (auto &&elem : assign.elems) {
+            if (elem.left.constant() && elem.right.constant()) {
+                dom.emplace_back(elem.left.fixed, elem.right.fixed);
+            }
+            else {
+                VariableSet vars;
+                elem.left.collect(vars);
+                elem.right.collect(vars);
+                exclude(vars);
+                simple = false;
+            }
+        }
+        if (simple) { candidates[var].domains.emplace_back(std::move(dom)); }
+        else {
+            for (auto &&elem : assign.elems) { candidates[elem.var].excluded = true; }
+        }
+    }
+    std::function<void (VariableSet &, Id_t)> collectTerms = [&](VariableSet &vars, Id_t termId) {
+        auto &&term = data_.getTerm(termId);
+        vars.emplace(termId);
+        if (term.type() == Theory_t::Compound) {
+            for (auto &&t : term) { collectTerms(vars, t); }
+        }
+    };
+    unsigned index = 0;
+    for (auto &&atom : data_) {
+        ++index;
+        auto &&term = data_.getTerm(atom->term());
+        Symbol sym = term.type() == Theory_t::Symbol ? symbol(atom->term()) : Symbol::Other;
+        if (sym == Symbol::Assign || sym == Symbol::Show) { continue; }
+        try {
+            switch (sym) {
+                case Symbol::Sum: {
+                    LinearTerm sum{0};
+                    for (auto &&elemId : *atom) {
+                        auto &&elem = requireEmptyCondition(elemId);
+                        require(elem.size() > 0, "not a valid constraint");
+                        sum = combine(std::move(sum), parseLinearTerm(*elem.begin()), Op::Add);
+                    }
+                    if (atom->guard()) { sum = combine(std::move(sum), parseLinearTerm(*atom->rhs()), Op::Sub); }
+                    sum.simplify();
+                    for (auto &&t : sum.terms) { candidates[t.first].occurrences.emplace_back(index, t.second, 0); }
+                    break;
+                }
+                case Symbol::Distinct: {
+                    for (auto &&elemId : *atom) {
+                        auto &&elem = requireEmptyCondition(elemId);
+                        require(elem.size() > 0, "not a valid constraint");
+                        LinearTerm e = parseLinearTerm(*elem.begin());
+                        e.simplify();
+                        if (e.terms.size() == 1) { candidates[e.terms.front().first].occurrences.emplace_back(index, e.terms.front().second, e.fixed); }
+                        else {
+                            VariableSet vars;
+                            e.collect(vars);
+                            exclude(vars);
+                        }
+                    }
+                    break;
+                }
+                case Symbol::Minimize: {
+                    for (auto &&elemId : *atom) {
+                        auto &&elem = requireEmptyCondition(elemId);
+                        require(elem.size() > 0, "invalid minimize directive");
+                        Id_t weight = *elem.begin();
+                        int prio = 0;
+                        auto &&wp = data_.getTerm(weight);
+                        if (wp.type() == Theory_t::Compound && function(wp) == Symbol::At && wp.size() == 2) {
+                            weight = *wp.begin();
+                            auto &&p = data_.getTerm(*(wp.begin() + 1));
+                            require(p.type() == Theory_t::Number, "invalid minimize directive");
+                            prio = p.number();
+                        }
+                        LinearTerm w = parseLinearTerm(weight);
+                        w.simplify();
+                        for (auto &&t : w.terms) { candidates[t.first].occurrences.emplace_back(index, t.second, prio); }
+                    }
+                    break;
+                }
+                default: {
+                    throw std::runtime_error("unknown theory atom");
+                }
+            }
+        }
+        catch (std::runtime_error const &) {
+            // Note: all variables in atoms that cannot be analyzed are excluded
+            VariableSet vars;
+            for (auto &&elemId : *atom) {
+                for (auto &&t : data_.getElement(elemId)) { collectTerms(vars, t); }
+            }
+            if (atom->guard()) { collectTerms(vars, *atom->rhs()); }
+            exclude(vars);
+        }
+    }
+    std::map<std::pair<std::vector<Variable::Domain>, std::vector<Occurrence>>, std::vector<Id_t>> groups;
+    for (auto &&ent : candidates) {
+        if (ent.second.excluded || ent.second.domains.empty()) { continue; }
+        // Note: like in addDom, the values of a variable are limited by its bound
+        Bound b = bound(ent.first);
+        for (auto &&dom : ent.second.domains) {
+            Variable::Domain clamped;
+            for (auto &&rng : dom) {
+                int left = std::max(b.first, rng.first), right = std::min(b.second, rng.second);
+                if (left <= right) { clamped.emplace_back(left, right); }
+            }
+            dom = std::move(clamped);
+        }
+        std::sort(ent.second.domains.begin(), ent.second.domains.end());
+        std::sort(ent.second.occurrences.begin(), ent.second.occurrences.end());
+        groups[std::make_pair(std::move(ent.second.domains), std::move(ent.second.occurrences))].emplace_back(ent.first);
+    }
+    for (auto &&group : groups) {
+        auto &vars = group.second;
+        for (auto it = vars.begin(), ie = vars.end(); it != ie && it + 1 != ie; ++it) {
+            // :- not &sum { vi } <= vi+1.
+            WeightLit_t body = {-lit(addSum(data, LinearTerm{0, {{*it, 1}}}, "<=", rewriteTerm(data, *(it + 1)))), 1};
+            printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {&body, 1}});
+        }
+    }
 }
 
 void FoundedOutput::rewriteShow(TheoryAtom const &atom) {
@@ -847,29 +1332,95 @@ void FoundedOutput::rewriteShow(TheoryAtom const &atom) {
         require(elem.size() == 1, message);
         auto &&term = data_.getTerm(*elem.begin());
         // NOTE: only slash notation is supported
-        require(term.type() == Theory_t::Compound && term.size() == 2 && term.isFunction(), message);
-        auto &&slash = data_.getTerm(term.function()).symbol();
-        require(strcmp(slash, "/") == 0, message);
+        require(term.type() == Theory_t::Compound && term.size() == 2 && function(term) == Symbol::Slash, message);
         auto &&name = data_.getTerm(*term.begin());
         require(name.type() == Theory_t::Symbol, message);
         auto &&arity = data_.getTerm(*(term.begin() + 1));
         require(arity.type() == Theory_t::Number, message);
-        showTable_.emplace(name.symbol(), arity.number());
+        showTable_.emplace(intern(*term.begin()), arity.number());
     }
 }
 
 void FoundedOutput::rewriteMinimize(Gringo::Output::TheoryData &data, TheoryAtom const &atom) {
-    rewriteAtom(data, atom, false, [this](TheoryElement const &elem){
+    std::vector<Id_t> weights;
+    rewriteAtom(data, atom, false, [this, &weights](TheoryElement const &elem){
         require(elem.size() >= 1, "invalid minimize directive");
         VariableSet vars;
         collectVariablesWeightPrio(vars, *elem.begin());
-        for (auto &&v : vars) {
-            if (varMap_.find(v) == varMap_.end()) {
-                return false;
+        std::vector<WeightLit_t> body;
+        bool mapped = collectUndefined(vars, body);
+        if (mapped) { weights.emplace_back(*elem.begin()); }
+        return mapped;
+    });
+    if (objectiveBounds_) { boundObjective(data, weights); }
+}
+
+bool FoundedOutput::valueRange(Id_t varId, std::pair<int64_t, int64_t> &range) const {
+    auto &&var = varMap_.find(varId)->second;
+    Bound b = bound(varId);
+    if (!var.bounded()) {
+        range = b;
+        return Variable::bounded(b.first, b.second);
+    }
+    bool empty = true;
+    for (auto &&d : var.domain) {
+        int left = std::max(b.first, d.first), right = std::min(b.second, d.second);
+        if (left > right) { continue; }
+        if (empty || left < range.first)   { range.first = left; }
+        if (empty || right > range.second) { range.second = right; }
+        empty = false;
+    }
+    // Note: a variable with an empty domain makes the program inconsistent anyway
+    return !empty;
+}
+
+void FoundedOutput::boundObjective(Gringo::Output::TheoryData &data, std::vector<Id_t> const &weights) {
+    std::map<int, LinearTerm> levels;
+    for (auto &&weight : weights) {
+        Id_t w = weight;
+        int prio = 0;
+        auto &&term = data_.getTerm(w);
+        if (term.type() == Theory_t::Compound && function(term) == Symbol::At && term.size() == 2) {
+            auto &&level = data_.getTerm(*(term.begin() + 1));
+            // Note: clingcon rejects non-numeric priorities
+            require(level.type() == Theory_t::Number, "invalid minimize directive");
+            prio = level.number();
+            w = *term.begin();
+        }
+        auto &&objective = levels.emplace(prio, LinearTerm{0}).first->second;
+        objective = combine(std::move(objective), parseLinearTerm(w), Op::Add);
+    }
+    for (auto &&level : levels) {
+        auto &objective = level.second;
+        objective.simplify();
+        if (objective.constant()) { continue; }
+        int64_t lower = objective.fixed, upper = objective.fixed;
+        bool bounded = true;
+        for (auto &&t : objective.terms) {
+            std::pair<int64_t, int64_t> range;
+            if (!valueRange(t.first, range)) {
+                bounded = false;
+                break;
+            }
+            // Note: the products fit into 64 bits but their sums might not
+            if (!addChecked(lower, t.second * (t.second > 0 ? range.first : range.second)) ||
+                !addChecked(upper, t.second * (t.second > 0 ? range.second : range.first))) {
+                bounded = false;
+                break;
             }
         }
-        return true;
-    });
+        if (!bounded) { continue; }
+        // :- &sum { objective } < lower.
+        // :- &sum { objective } > upper.
+        if (lower >= std::numeric_limits<int>::min()) {
+            WeightLit_t body = {lit(addSum(data, objective, "<", data.addTerm(static_cast<int>(lower)))), 1};
+            printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {&body, 1}});
+        }
+        if (upper <= std::numeric_limits<int>::max()) {
+            WeightLit_t body = {lit(addSum(data, objective, ">", data.addTerm(static_cast<int>(upper)))), 1};
+            printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {&body, 1}});
+        }
+    }
 }
 
 Id_t FoundedOutput::rewriteTerm(Gringo::Output::TheoryData &data, Id_t termId) {
@@ -891,7 +1442,7 @@ Id_t FoundedOutput::rewriteTerm(Gringo::Output::TheoryData &data, Id_t termId) {
     throw std::logic_error("must not happen");
 }
 
-Id_t FoundedOutput::addSum(Gringo::Output::TheoryData &data, LinearTerm const &term, char const *rel, Id_t rhs) {
+Atom_t FoundedOutput::addSum(Gringo::Output::TheoryData &data, LinearTerm const &term, char const *rel, Id_t rhs) {
     std::vector<Id_t> elems;
     Id_t te = data.addTerm(term.fixed);
     elems.emplace_back(data.addElem({&te, 1}, {}));
@@ -900,14 +1451,13 @@ Id_t FoundedOutput::addSum(Gringo::Output::TheoryData &data, LinearTerm const &t
         te = data.addTerm(data.addTerm("*"), {cv, 2});
         elems.emplace_back(data.addElem({&te, 1}, {}));
     }
-    auto &&newAtom = [&]() { return atoms_++; };
     auto &&ret = data.addAtom(
-        newAtom,
+        [&]() { return newAtom("sum"); },
         TheoryAtom::Occurrence::occ_body,
         data.addTerm("sum"),
         toSpan(elems),
         data.addTerm(rel),
-        rewriteTerm(data, rhs));
+        rhs);
     return ret.first.atom();
 }
 
@@ -930,30 +1480,31 @@ Atom_t FoundedOutput::rewriteAtom(Gringo::Output::TheoryData &data, TheoryAtom c
             Gringo::Output::LitVec cond;
             if (elem.condition()) {
                 cond.reserve(conditions_[elem.condition() - 1].size());
-                for (auto &&lit : conditions_[elem.condition() - 1]) {
+                for (auto &&l : conditions_[elem.condition() - 1]) {
+                    Lit_t lit = mapLit(l);
                     cond.emplace_back(Gringo::Output::LiteralId{
                         lit > 0 ? Gringo::NAF::POS : Gringo::NAF::NOT,
                         Gringo::Output::AtomType::Aux,
-                        Potassco::atom(std::abs(lit)), 0});
+                        Potassco::atom(lit), 0});
                 }
             }
             elems.emplace_back(data.addElem(toSpan(tuple), std::move(cond)));
         }
     }
-    auto &&newAtom = [&]() {
+    auto &&theoryAtom = [&]() {
         return atom.atom() && reMap
-            ? atoms_++
-            : atom.atom();
+            ? newAtom("theory")
+            : (atom.atom() ? mapAtom(atom.atom()) : 0);
     };
     return (atom.guard()
-        ? data.addAtom(newAtom, atom.occurrence(), rewriteTerm(data, atom.term()), toSpan(elems), rewriteTerm(data, *atom.guard()), rewriteTerm(data, *atom.rhs()))
-        : data.addAtom(newAtom, atom.occurrence(), rewriteTerm(data, atom.term()), toSpan(elems))).first.atom();
+        ? data.addAtom(theoryAtom, atom.occurrence(), rewriteTerm(data, atom.term()), toSpan(elems), rewriteTerm(data, *atom.guard()), rewriteTerm(data, *atom.rhs()))
+        : data.addAtom(theoryAtom, atom.occurrence(), rewriteTerm(data, atom.term()), toSpan(elems))).first.atom();
 }
 
-void FoundedOutput::addDom(Gringo::Output::TheoryData &data, Id_t var, std::vector<std::pair<int, int>> const &def) {
+void FoundedOutput::addDom(Gringo::Output::TheoryData &data, Id_t var, std::vector<std::pair<int, int>> const &def, Bound const &bound) {
     std::vector<Id_t> elems;
     for (auto &&d : def) {
-        Id_t terms[2] = {data.addTerm(std::max(min_, d.first)), data.addTerm(std::min(max_, d.second))};
+        Id_t terms[2] = {data.addTerm(std::max(bound.first, d.first)), data.addTerm(std::min(bound.second, d.second))};
         Id_t tuple = data.addTerm(data.addTerm(".."), {terms, 2});
         elems.emplace_back(data.addElem({&tuple, 1}, {}));
     }
@@ -967,21 +1518,55 @@ void FoundedOutput::addDom(Gringo::Output::TheoryData &data, Id_t var, std::vect
         rewriteTerm(data, var));
 }
 
+FoundedOutput::Signature FoundedOutput::signature(Id_t varId) const {
+    auto &&var = data_.getTerm(varId);
+    if (var.type() == Theory_t::Symbol) {
+        return {intern(varId), 0};
+    }
+    require(var.type() == Theory_t::Compound && var.isFunction(), "not a valid variable");
+    return {intern(var.function()), var.size()};
+}
+
+void FoundedOutput::printVariable(std::ostream &out, Id_t termId) const {
+    auto &&term = data_.getTerm(termId);
+    switch (term.type()) {
+        case Theory_t::Number: { out << term.number(); break; }
+        case Theory_t::Symbol: { out << term.symbol(); break; }
+        case Theory_t::Compound: {
+            auto &parens = Tuple_t::parens(term.isTuple() ? term.tuple() : Tuple_t::Paren);
+            if (term.isFunction()) { printVariable(out, term.function()); }
+            out << parens.first;
+            bool comma = false;
+            for (auto &&t : term) {
+                if (comma) { out << ","; }
+                else       { comma = true; }
+                printVariable(out, t);
+            }
+            if (term.isTuple() && term.tuple() == TupleType::Paren && term.size() == 1) { out << ","; }
+            out << parens.second;
+            break;
+        }
+    }
+}
+
+FoundedOutput::Bound FoundedOutput::bound(Id_t varId) const {
+    if (!termBounds_.empty()) {
+        std::ostringstream oss;
+        printVariable(oss, varId);
+        auto it = termBounds_.find(oss.str());
+        if (it != termBounds_.end()) { return it->second; }
+    }
+    if (!signatureBounds_.empty()) {
+        auto it = signatureBounds_.find(signature(varId));
+        if (it != signatureBounds_.end()) { return it->second; }
+    }
+    return {min_, max_};
+}
+
 void FoundedOutput::showVariable(Gringo::Output::TheoryData &data, Id_t varId, Variable &var, std::vector<Id_t> &elems) {
     bool show = showTable_.empty();
     if (!show) {
-        auto &&var = data_.getTerm(varId);
-        int arity = 0;
-        char const *name;
-        if (var.type() == Theory_t::Symbol) {
-            name = var.symbol();
-        }
-        else {
-            require(var.type() == Theory_t::Compound && var.isFunction(), "not a valid variable");
-            name = data_.getTerm(var.function()).symbol();
-            arity = var.size();
-        }
-        show = showTable_.find(std::make_pair(name, arity)) != showTable_.end();
+        show = showTable_.find(signature(varId)) != showTable_.end();
     }
     if (show) {
         Id_t term = rewriteTerm(data, varId);
@@ -992,16 +1577,23 @@ void FoundedOutput::showVariable(Gringo::Output::TheoryData &data, Id_t varId, V
 }
 
 void FoundedOutput::endStep() {
-    TheoryData d;
-    Gringo::Output::TheoryData data(d);
-    for (auto &&atom : data_) {
+    // Note: only theory atoms of the current step are translated
+    //       while variables and their atoms persist across steps
+    auto &data = outTheory_;
+    stepBegin_ = atoms_;
+    outData_.update();
+    for (auto it = data_.currBegin(), ie = data_.end(); it != ie; ++it) {
+        auto &&atom = *it;
         auto &&term = data_.getTerm(atom->term());
         if (term.type() == Theory_t::Symbol) {
-            auto &&name = term.symbol();
-            if      (strcmp(name, ASSIGN) == 0) { rewriteDom(*atom); }
-            else if (strcmp(name, "show") == 0) { rewriteShow(*atom); }
+            switch (symbol(atom->term())) {
+                case Symbol::Assign: { rewriteDom(*atom); break; }
+                case Symbol::Show:   { rewriteShow(*atom); break; }
+                default:             { break; }
+            }
         }
     }
+    if (dropUnused_) { dropUnused(); }
     // TODO: detect defined variables
     for (auto &&assign : assign_) {
         Id_t var;
@@ -1013,16 +1605,26 @@ void FoundedOutput::endStep() {
     for (auto &&assign : assign_) {
         printAssign(data, assign);
     }
-    std::vector<Id_t> elems;
-    for (auto &&ent : varMap_) {
-        showVariable(data, ent.first, ent.second, elems);
-        if (!ent.second.defined) {
-            if (ent.second.bounded()) {
-                ent.second.extend(0, 0);
+    if (breakSymmetries_) {
+        setOrigin("symmetry", 0);
+        breakSymmetries(data);
+    }
+    if (heuristic_ != Heuristic::None) { printHeuristics(); }
+    if (warmStart_) { warmStart(data); }
+    std::vector<Id_t> elems, shown;
+    for (auto &&varId : stepVars_) {
+        auto &&var = varMap_.find(varId)->second;
+        setOrigin("variable", 0, varId);
+        size_t numElems = elems.size();
+        showVariable(data, varId, var, elems);
+        if (elems.size() != numElems) { shown.emplace_back(varId); }
+        if (!var.defined) {
+            if (var.bounded()) {
+                var.extend(0, 0);
             }
             // :- not v, #sum {v} != 0.
-            WeightLit_t body[2] = {{-lit(ent.second.atom), 1}, {lit(addSum(data, ent.first, "!=", data.addTerm(0))), 1}};
-            rule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {body, 2}});
+            WeightLit_t body[2] = {{-lit(var.atom), 1}, {lit(addSum(data, varId, "!=", data.addTerm(0))), 1}};
+            printRule({Head_t::Disjunctive, {nullptr, 0}}, {Body_t::Normal, 1, {body, 2}});
         }
     }
     data.addAtom(
@@ -1030,32 +1632,59 @@ void FoundedOutput::endStep() {
         TheoryAtom::Occurrence::occ_head,
         data.addTerm("show"),
         toSpan(elems));
-    for (auto &&ent : varMap_) {
+    for (auto &&varId : stepVars_) {
         // &dom { l1..r1; ...; ln..rn } = v.
-        if (ent.second.bounded()) {
-            addDom(data, ent.first, ent.second.domain);
+        auto &&var = varMap_.find(varId)->second;
+        Bound b = bound(varId);
+        if (var.bounded()) {
+            addDom(data, varId, var.domain, b);
         }
-        else if (ent.second.bounded(min_, max_)) {
-            addDom(data, ent.first, {{min_, max_}});
+        else if (var.bounded(b.first, b.second)) {
+            addDom(data, varId, {b}, b);
         }
     }
-    for (auto &&atom : data_) {
+    if (project_) { printProjection(data, shown); }
+    for (auto it = data_.currBegin(), ie = data_.end(); it != ie; ++it) {
+        auto &&atom = *it;
         auto &&term = data_.getTerm(atom->term());
+        setOrigin(*atom);
         if (term.type() == Theory_t::Symbol) {
-            auto &&name = term.symbol();
-            if      (strcmp(name, ASSIGN)     == 0) {                                 continue; }
-            else if (strcmp(name, "show")     == 0) {                                 continue; }
-            else if (strcmp(name, "sum")      == 0) { rewriteConstraint(data, *atom); continue; }
-            else if (strcmp(name, "distinct") == 0) { rewriteConstraint(data, *atom); continue; }
-            else if (strcmp(name, "minimize") == 0) { rewriteMinimize(data, *atom);   continue; }
+            switch (symbol(atom->term())) {
+                case Symbol::Assign:   {                                 continue; }
+                case Symbol::Show:     {                                 continue; }
+                case Symbol::Sum:      { rewriteConstraint(data, *atom); continue; }
+                case Symbol::Distinct: { rewriteConstraint(data, *atom); continue; }
+                case Symbol::Minimize: { rewriteMinimize(data, *atom);   continue; }
+                default:               {                                 break; }
+            }
         }
         rewriteAtom(data, *atom, false);
     }
-    TheoryPrinter p(data, out_);
-    for (auto &&atom : data.data()) {
-        p.printTheoryAtom(*atom);
+    auto getCond = [&data](Id_t elemId) { return getCondition(data, elemId); };
+    if (eager_) {
+        EagerEncoder::AtomVec atoms(outData_.currBegin(), outData_.end());
+        Atom_t begin = atoms_;
+        for (auto &&atom : EagerEncoder(out_, data, eager_).encode(atoms, atoms_, getCond)) {
+            out_.printTheoryAtom(*atom, getCond);
+        }
+        if (provenance_) {
+            // Note: the encoder shares atoms among constraints
+            setOrigin(nullptr, 0);
+            for (Atom_t a = begin; a != atoms_; ++a) { printProvenance(a, "eager", noVar); }
+        }
+    }
+    else {
+        for (auto it = outData_.currBegin(), ie = outData_.end(); it != ie; ++it) {
+            out_.printTheoryAtom(**it, getCond);
+        }
     }
-    out_ << "0\n";
+    data_.update();
+    assign_.clear();
+    stepVars_.clear();
+    undefinedAux_.clear();
+    undefinedVarAux_.clear();
+    origin_ = Origin();
+    out_.endStep();
 }
 
 // }}}1
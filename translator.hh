@@ -21,12 +21,17 @@
 #include <potassco/basic_types.h>
 #include <potassco/theory_data.h>
 #include <gringo/output/theory.hh>
+#include <gringo/output/backend.hh>
+#include <limits>
+#include <unordered_set>
 
 using ConditionVec = std::vector<std::vector<Potassco::Lit_t>>;
 
 
 class FoundedOutput : public Potassco::LpElement {
     enum class Op { Add, Sub, Mul };
+    // Note: symbols with a special meaning, all other symbols are interned after Other
+    enum class Symbol : unsigned { Assign, Show, Sum, Distinct, Minimize, Add, Sub, Mul, Range, Define, Slash, At, Other };
     struct Define;
     struct SimpleDefine;
     struct GeneralDefine;
@@ -56,13 +61,70 @@ class FoundedOutput : public Potassco::LpElement {
     using Disjunctions = std::vector<Disjunction>;
     // TODO: better put the variable id into the variable class and make this a set...
     using VariableMap = std::unordered_map<Potassco::Id_t, Variable>;
-    using ShowTable = std::set<std::pair<char const *, int>>;
+    using Signature = std::pair<unsigned, int>;
+    struct SignatureHash {
+        size_t operator()(Signature const &sig) const {
+            return std::hash<uint64_t>()(static_cast<uint64_t>(sig.first) << 32 | static_cast<uint32_t>(sig.second));
+        }
+    };
+    using ShowTable = std::unordered_set<Signature, SignatureHash>;
     using Facts = std::unordered_set<Potassco::Atom_t>;
+    using Bound = std::pair<int, int>;
+    using SignatureBounds = std::unordered_map<Signature, Bound, SignatureHash>;
+    using TermBounds = std::unordered_map<std::string, Bound>;
+    using InitialValues = std::unordered_map<std::string, int>;
+    using InitialAtoms = std::unordered_set<std::string>;
+    // the theory atom and variable the atoms introduced next stem from
+    static constexpr Potassco::Id_t noVar = std::numeric_limits<Potassco::Id_t>::max();
+    struct Origin {
+        char const *name = nullptr;
+        Potassco::Atom_t source = 0;
+        Potassco::Id_t var = noVar;
+        char const *define = nullptr;
+    };
+    using SymbolTable = std::unordered_map<std::string, unsigned>;
+    using UndefinedAux = std::map<std::vector<Potassco::Atom_t>, Potassco::Atom_t>;
+    using UndefinedVarAux = std::unordered_map<Potassco::Id_t, Potassco::Atom_t>;
 public:
-    FoundedOutput(std::ostream& out, ConditionVec &conditions, Potassco::TheoryData &data, int min, int max);
+    enum class Heuristic { None, Sign, Level, Factor };
+    // Translated programs are passed to the given backend; theory atoms are
+    // added to outData, which has to be the theory data used by the backend.
+    FoundedOutput(Gringo::Output::Backend &out, Potassco::TheoryData &outData, ConditionVec &conditions, Potassco::TheoryData &data, int min, int max);
     FoundedOutput(const FoundedOutput&) = delete;
     FoundedOutput& operator=(const FoundedOutput&) = delete;
     virtual ~FoundedOutput() noexcept;
+    // Bounds for variables with the given signature; take precedence over the global bounds.
+    void addBound(std::string const &name, int arity, int min, int max);
+    // Bounds for the variable with the given ground term; take precedence over signature bounds.
+    void addBound(std::string const &term, int min, int max);
+    // Order the values of interchangeable variables; this changes the enumerated solutions.
+    void enableSymmetryBreaking(bool enable);
+    // Order encode variables and constraints needing at most limit clauses as
+    // plain rules instead of passing them on as theory atoms; 0 disables this.
+    void enableEager(unsigned limit);
+    // Add redundant constraints bounding the objective of each minimize
+    // priority level by the domains of its variables.
+    void enableObjectiveBounds(bool enable);
+    // Drop assignments of variables that are neither shown nor used in any
+    // constraint; this changes the enumerated solutions.
+    void enableUnusedElimination(bool enable);
+    // Emit #heuristic directives for the atoms introduced by the translation:
+    // Sign prefers defining variables and choosing assignment ranges,
+    // Level and Factor additionally decide ranges with small domains first.
+    void enableHeuristic(Heuristic heuristic);
+    // Prefer the values and shown atoms of a previous solution when solving;
+    // shown atoms that are not added are preferred to be false.
+    void enableWarmStart(bool enable);
+    // The value of the variable with the given ground term in the previous solution.
+    void addInitialValue(std::string const &term, int value);
+    // A shown atom true in the previous solution.
+    void addInitialAtom(std::string const &atom);
+    // Write a JSON object per line to out for each atom introduced by the
+    // translation naming the kind of the atom and where it stems from.
+    void enableProvenance(std::ostream *out);
+    // Project solutions onto the shown atoms and the values of the shown
+    // variables, which must have at most limit values; 0 disables this.
+    void enableProjection(unsigned limit);
     virtual void initProgram(bool);
     virtual void beginStep();
     virtual void rule(const Potassco::HeadView& head, const Potassco::BodyView& body);
@@ -79,6 +141,8 @@ private:
     void rewriteConstraint(Gringo::Output::TheoryData &data, Potassco::TheoryAtom const &atom);
     void rewriteShow(Potassco::TheoryAtom const &atom);
     void rewriteMinimize(Gringo::Output::TheoryData &data, Potassco::TheoryAtom const &atom);
+    void boundObjective(Gringo::Output::TheoryData &data, std::vector<Potassco::Id_t> const &weights);
+    bool valueRange(Potassco::Id_t varId, std::pair<int64_t, int64_t> &range) const;
     Potassco::Id_t rewriteTerm(Gringo::Output::TheoryData &data, Potassco::Id_t term);
     Potassco::Id_t rewriteTerm(Gringo::Output::TheoryData &data, LinearTerm const &term);
     template <class ElemFilter>
@@ -87,13 +151,22 @@ private:
     VariableSet collectVariables(Potassco::TheoryAtom const &atom) const;
     void collectVariables(VariableSet &variables, Potassco::Id_t termId) const;
     void collectVariablesWeightPrio(VariableSet &vars, Potassco::Id_t termId) const;
-    bool isOp(char const *op) const;
+    bool collectUndefined(VariableSet const &vars, std::vector<Potassco::WeightLit_t> &body) const;
+    unsigned intern(char const *name) const;
+    unsigned intern(Potassco::Id_t termId) const;
+    Symbol symbol(Potassco::Id_t termId) const;
+    Symbol function(Potassco::TheoryTerm const &term) const;
+    static bool isOp(Symbol sym);
     void require(bool exp, char const *message) const;
     Potassco::TheoryElement const &requireEmptyCondition(Potassco::Id_t elemId) const;
     Variable &mapVar(Potassco::Id_t var);
     Potassco::Atom_t addSum(Gringo::Output::TheoryData &data, Potassco::Id_t term, char const *rel, Potassco::Id_t rhs);
-    Potassco::Id_t addSum(Gringo::Output::TheoryData &data, LinearTerm const &term, char const *rel, Potassco::Id_t rhs);
-    void addDom(Gringo::Output::TheoryData &data, Potassco::Id_t var, std::vector<std::pair<int, int>> const &dom);
+    // Note: unlike term, rhs refers to a term in data
+    Potassco::Atom_t addSum(Gringo::Output::TheoryData &data, LinearTerm const &term, char const *rel, Potassco::Id_t rhs);
+    void addDom(Gringo::Output::TheoryData &data, Potassco::Id_t var, std::vector<std::pair<int, int>> const &dom, Bound const &bound);
+    Signature signature(Potassco::Id_t varId) const;
+    void printVariable(std::ostream &out, Potassco::Id_t termId) const;
+    Bound bound(Potassco::Id_t varId) const;
     void showVariable(Gringo::Output::TheoryData &data, Potassco::Id_t varId, Variable &var, std::vector<Potassco::Id_t> &elems);
     Potassco::Id_t requireNotOperator(Potassco::Id_t termId) const;
     Potassco::Id_t requireVariable(Potassco::Id_t termId) const;
@@ -102,18 +175,69 @@ private:
     LinearTerm parseLinearTerm_(Potassco::Id_t ti);
     LinearTerm parseLinearTerm(Potassco::Id_t ti);
     void printAssign(Gringo::Output::TheoryData &data, Disjunction const &assign);
+    void breakSymmetries(Gringo::Output::TheoryData &data);
+    void dropUnused();
+    void printHeuristics();
+    bool initialValue(Potassco::Id_t varId, int &value) const;
+    void warmStart(Gringo::Output::TheoryData &data);
+    void setOrigin(char const *name, Potassco::Atom_t source, Potassco::Id_t var = noVar, char const *define = nullptr);
+    void setOrigin(Potassco::TheoryAtom const &atom);
+    Potassco::Atom_t newAtom(char const *kind, Potassco::Id_t var = noVar);
+    void printProvenance(Potassco::Atom_t atom, char const *kind, Potassco::Id_t var);
+    void printProjection(Gringo::Output::TheoryData &data, std::vector<Potassco::Id_t> const &shown);
     bool isFact() const;
+    bool isNew(Variable const &var) const;
+    Potassco::Atom_t mapAtom(Potassco::Atom_t atom);
+    Potassco::Lit_t mapLit(Potassco::Lit_t lit);
+    void printRule(const Potassco::HeadView& head, const Potassco::BodyView& body);
+    Gringo::Output::Backend::AtomVec &toAtoms(Potassco::AtomSpan const &atoms);
+    Gringo::Output::Backend::LitVec &toLits(Potassco::LitSpan const &lits);
+    Gringo::Output::Backend::LitWeightVec &toWLits(Potassco::WeightLitSpan const &lits);
 
-    std::ostream& out_;
+    Gringo::Output::Backend &out_;
+    Potassco::TheoryData &outData_;
+    Gringo::Output::TheoryData outTheory_;
     Potassco::TheoryData &data_;
     ConditionVec &conditions_;
     Potassco::Atom_t atoms_;
+    // maps input atoms to output atoms in incremental programs
+    std::vector<Potassco::Atom_t> inputAtoms_;
+    std::vector<Potassco::Atom_t> headBuf_;
+    std::vector<Potassco::WeightLit_t> bodyBuf_;
+    // atoms below this one have been introduced in earlier steps
+    Potassco::Atom_t stepBegin_ = 0;
     VariableMap varMap_;
+    // variables mapped in the current step
+    std::vector<Potassco::Id_t> stepVars_;
+    // variables referenced in earlier steps before being mapped
+    mutable VariableSet referenced_;
     ShowTable showTable_;
     Disjunctions assign_;
     Facts facts_;
+    UndefinedAux undefinedAux_;
+    UndefinedVarAux undefinedVarAux_;
+    SignatureBounds signatureBounds_;
+    TermBounds termBounds_;
+    InitialValues initialValues_;
+    InitialAtoms initialAtoms_;
+    mutable SymbolTable symbols_;
+    mutable std::vector<unsigned> termSymbols_;
     int min_;
     int max_;
+    bool breakSymmetries_ = false;
+    unsigned eager_ = 0;
+    bool objectiveBounds_ = false;
+    bool dropUnused_ = false;
+    Heuristic heuristic_ = Heuristic::None;
+    // domain sizes of the choices for assignment ranges of the current step
+    std::vector<std::pair<uint64_t, Potassco::Atom_t>> choices_;
+    bool warmStart_ = false;
+    std::ostream *provenance_ = nullptr;
+    unsigned project_ = 0;
+    // atoms occurring in output statements of the current step
+    std::vector<Potassco::Atom_t> projectAtoms_;
+    Origin origin_;
+    bool incremental_ = false;
 };
 
 #endif